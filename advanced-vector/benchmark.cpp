@@ -0,0 +1,412 @@
+// Сравнение производительности Vector и std::vector.
+// Запуск: benchmark [--filter=подстрока] [--max-size=N] [--min-time-ms=N]
+// Для каждого теста выводится время на операцию, число и объём выделений памяти
+// и объём скопированных или перемещённых элементов за одну итерацию
+#include "vector.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct AllocationStats {
+    size_t allocations = 0;
+    size_t bytes = 0;
+};
+
+AllocationStats g_allocation_stats;
+
+}  // namespace
+
+// Замена глобальных операторов учитывает все выделения памяти, включая выделения внутри элементов.
+// Операторы не встраиваются, чтобы компилятор не сопоставлял malloc и free с new и delete
+[[gnu::noinline]] void* operator new(size_t size) {
+    ++g_allocation_stats.allocations;
+    g_allocation_stats.bytes += size;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, size_t /*size*/) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+template <typename T>
+void DoNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+struct Pod64 {
+    uint64_t fields[8];
+};
+
+// Тип с пользовательскими копированием и перемещением, аналогичный Obj из main.cpp
+struct Obj {
+    Obj() = default;
+    explicit Obj(int id)
+        : id(id)  //
+    {
+    }
+    Obj(const Obj& other)
+        : id(other.id)
+        , name(other.name)  //
+    {
+    }
+    Obj(Obj&& other) noexcept
+        : id(other.id)
+        , name(std::move(other.name))  //
+    {
+    }
+    Obj& operator=(const Obj& other) {
+        id = other.id;
+        name = other.name;
+        return *this;
+    }
+    Obj& operator=(Obj&& other) noexcept {
+        id = other.id;
+        name = std::move(other.name);
+        return *this;
+    }
+
+    int id = 0;
+    std::string name;
+};
+
+// Обёртка, подсчитывающая копирования и перемещения значения типа T. Тривиальные типы теряют
+// тривиальность, поэтому обёртка используется только в отдельном проходе без замера времени,
+// а каждый побайтовый перенос элемента считается одним перемещением
+template <typename T>
+struct Counted {
+    using ValueType = T;
+
+    Counted() = default;
+    explicit Counted(T value)
+        : value(std::move(value))  //
+    {
+    }
+    Counted(const Counted& other)
+        : value(other.value)  //
+    {
+        ++transfers;
+    }
+    Counted(Counted&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value(std::move(other.value))  //
+    {
+        ++transfers;
+    }
+    Counted& operator=(const Counted& other) {
+        value = other.value;
+        ++transfers;
+        return *this;
+    }
+    Counted& operator=(Counted&& other) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        value = std::move(other.value);
+        ++transfers;
+        return *this;
+    }
+
+    T value{};
+
+    static inline size_t transfers = 0;
+};
+
+template <typename T>
+inline constexpr bool IS_COUNTED = false;
+template <typename T>
+inline constexpr bool IS_COUNTED<Counted<T>> = true;
+
+template <typename T>
+T MakeValue(size_t i) {
+    if constexpr (IS_COUNTED<T>) {
+        return T(MakeValue<typename T::ValueType>(i));
+    } else if constexpr (std::is_same_v<T, int>) {
+        return static_cast<int>(i);
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        return Pod64{{i, i, i, i, i, i, i, i}};
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        // Строка длиннее буфера SSO, чтобы копирование требовало выделения памяти
+        return std::string(32, static_cast<char>('a' + i % 26));
+    } else {
+        return Obj(static_cast<int>(i));
+    }
+}
+
+template <typename T>
+constexpr std::string_view TypeName() {
+    if constexpr (IS_COUNTED<T>) {
+        return TypeName<typename T::ValueType>();
+    } else if constexpr (std::is_same_v<T, int>) {
+        return "int";
+    } else if constexpr (std::is_same_v<T, Pod64>) {
+        return "Pod64";
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return "string";
+    } else {
+        return "Obj";
+    }
+}
+
+// Единый интерфейс к сравниваемым контейнерам
+template <typename T>
+struct StdVectorOps {
+    using Container = std::vector<T>;
+    static constexpr std::string_view NAME = "std::vector";
+
+    static void PushBack(Container& c, const T& value) {
+        c.push_back(value);
+    }
+    static void EmplaceBack(Container& c, size_t i) {
+        c.emplace_back(MakeValue<T>(i));
+    }
+    static void Reserve(Container& c, size_t n) {
+        c.reserve(n);
+    }
+    static void Insert(Container& c, size_t index, const T& value) {
+        c.insert(c.begin() + index, value);
+    }
+    static void Erase(Container& c, size_t index) {
+        c.erase(c.begin() + index);
+    }
+    static size_t Size(const Container& c) {
+        return c.size();
+    }
+};
+
+template <typename T>
+struct VectorOps {
+    using Container = Vector<T>;
+    static constexpr std::string_view NAME = "Vector";
+
+    static void PushBack(Container& c, const T& value) {
+        c.PushBack(value);
+    }
+    static void EmplaceBack(Container& c, size_t i) {
+        c.EmplaceBack(MakeValue<T>(i));
+    }
+    static void Reserve(Container& c, size_t n) {
+        c.Reserve(n);
+    }
+    static void Insert(Container& c, size_t index, const T& value) {
+        c.Insert(c.begin() + index, value);
+    }
+    static void Erase(Container& c, size_t index) {
+        c.Erase(c.begin() + index);
+    }
+    static size_t Size(const Container& c) {
+        return c.Size();
+    }
+};
+
+struct Options {
+    std::string filter;
+    size_t max_size = 1'000'000;
+    int64_t min_time_ns = 100'000'000;
+};
+
+Options g_options;
+
+// Собственные затраты на пару вызовов steady_clock::now, вычитаемые из каждого замера
+int64_t MeasureTimerOverhead() {
+    int64_t best = std::numeric_limits<int64_t>::max();
+    for (int i = 0; i < 1000; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto stop = std::chrono::steady_clock::now();
+        best = std::min<int64_t>(best, std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+    }
+    return best;
+}
+
+const int64_t TIMER_OVERHEAD_NS = MeasureTimerOverhead();
+
+bool IsSelected(const std::string& name) {
+    return name.find(g_options.filter) != std::string::npos;
+}
+
+// Выполняет body(setup()) до набора минимального времени и печатает усреднённый результат.
+// Время подготовки и уничтожения состояния не учитывается. bytes_moved — объём элементов,
+// перенесённых за одну итерацию
+template <typename Setup, typename Body>
+void Run(const std::string& name, size_t ops_per_iteration, size_t bytes_moved, Setup setup, Body body) {
+    int64_t total_ns = 0;
+    size_t iterations = 0;
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    while (iterations == 0 || total_ns < g_options.min_time_ns) {
+        auto state = setup();
+        const AllocationStats before = g_allocation_stats;
+        const auto start = std::chrono::steady_clock::now();
+        body(state);
+        const auto stop = std::chrono::steady_clock::now();
+        DoNotOptimize(state);
+        const int64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+        total_ns += std::max<int64_t>(0, elapsed_ns - TIMER_OVERHEAD_NS);
+        allocations += g_allocation_stats.allocations - before.allocations;
+        allocated_bytes += g_allocation_stats.bytes - before.bytes;
+        ++iterations;
+    }
+
+    std::printf("%-48s %12.2f %12zu %14zu %14zu %10zu\n", name.c_str(),
+                static_cast<double>(total_ns) / static_cast<double>(iterations * ops_per_iteration),
+                allocations / iterations, allocated_bytes / iterations, bytes_moved, iterations);
+}
+
+template <template <typename> typename Ops, typename T>
+std::string MakeName(std::string_view benchmark, size_t size) {
+    std::string name(benchmark);
+    name += '<';
+    name += Ops<T>::NAME;
+    name += ", ";
+    name += TypeName<T>();
+    name += ">/";
+    name += std::to_string(size);
+    return name;
+}
+
+// Вызывает visit(name, ops_per_iteration, setup, body) для каждого теста контейнера Ops<T> размера size
+template <template <typename> typename Ops, typename T, typename Visit>
+void ForEachBenchmark(size_t size, Visit visit) {
+    using O = Ops<T>;
+    using Container = typename O::Container;
+    const T value = MakeValue<T>(size);
+    auto make_filled = [size] {
+        Container c;
+        for (size_t i = 0; i < size; ++i) {
+            O::EmplaceBack(c, i);
+        }
+        return c;
+    };
+
+    visit(MakeName<Ops, T>("PushBack", size), size, [] { return Container{}; },
+        [&](Container& c) {
+            for (size_t i = 0; i < size; ++i) {
+                O::PushBack(c, value);
+            }
+        });
+    visit(MakeName<Ops, T>("EmplaceBack", size), size, [] { return Container{}; },
+        [&](Container& c) {
+            for (size_t i = 0; i < size; ++i) {
+                O::EmplaceBack(c, i);
+            }
+        });
+    visit(MakeName<Ops, T>("ReservePushBack", size), size, [] { return Container{}; },
+        [&](Container& c) {
+            O::Reserve(c, size);
+            for (size_t i = 0; i < size; ++i) {
+                O::PushBack(c, value);
+            }
+        });
+
+    // Вставка и удаление в середине квадратичны, поэтому выполняется фиксированное число операций
+    const size_t middle_ops = 64;
+    visit(MakeName<Ops, T>("InsertMiddle", size), middle_ops, make_filled, [&](Container& c) {
+        for (size_t i = 0; i < middle_ops; ++i) {
+            O::Insert(c, O::Size(c) / 2, value);
+        }
+    });
+    if (size >= middle_ops) {
+        visit(MakeName<Ops, T>("EraseMiddle", size), middle_ops, make_filled, [&](Container& c) {
+            for (size_t i = 0; i < middle_ops; ++i) {
+                O::Erase(c, O::Size(c) / 2);
+            }
+        });
+    }
+
+    const Container source = make_filled();
+    visit(MakeName<Ops, T>("CopyAssign", size), size, make_filled, [&](Container& c) {
+        c = source;
+    });
+    visit(MakeName<Ops, T>("CopyConstruct", size), size, [] { return std::optional<Container>{}; },
+        [&](std::optional<Container>& c) {
+            c.emplace(source);
+        });
+    visit(MakeName<Ops, T>("MoveAssign", size), 1, [&] { return std::pair{make_filled(), Container{}}; },
+        [](std::pair<Container, Container>& p) {
+            p.second = std::move(p.first);
+        });
+    visit(MakeName<Ops, T>("Iterate", size), size, [] { return size_t{0}; }, [&](size_t& checksum) {
+        for (const T& elem : source) {
+            DoNotOptimize(elem);
+            ++checksum;
+        }
+    });
+}
+
+// Сначала подсчитывает переносы элементов за одну итерацию каждого теста на Counted<T>,
+// затем замеряет те же тесты на T
+template <template <typename> typename Ops, typename T>
+void RunSuite(size_t size) {
+    std::vector<size_t> transfers;
+    ForEachBenchmark<Ops, Counted<T>>(size, [&transfers](const std::string& name, size_t /*ops*/, auto setup,
+                                                         auto body) {
+        if (!IsSelected(name)) {
+            transfers.push_back(0);
+            return;
+        }
+        auto state = setup();
+        const size_t before = Counted<T>::transfers;
+        body(state);
+        transfers.push_back(Counted<T>::transfers - before);
+    });
+    size_t index = 0;
+    ForEachBenchmark<Ops, T>(size, [&transfers, &index](const std::string& name, size_t ops_per_iteration,
+                                                        auto setup, auto body) {
+        const size_t bytes_moved = transfers[index++] * sizeof(T);
+        if (IsSelected(name)) {
+            Run(name, ops_per_iteration, bytes_moved, std::move(setup), std::move(body));
+        }
+    });
+}
+
+template <typename T>
+void RunForType() {
+    for (size_t size = 1; size <= g_options.max_size; size *= 10) {
+        RunSuite<StdVectorOps, T>(size);
+        RunSuite<VectorOps, T>(size);
+    }
+}
+
+void ParseOptions(int argc, char* argv[]) {
+    using namespace std::literals;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.substr(0, "--filter="sv.size()) == "--filter="sv) {
+            g_options.filter = arg.substr("--filter="sv.size());
+        } else if (arg.substr(0, "--max-size="sv.size()) == "--max-size="sv) {
+            g_options.max_size = std::stoull(std::string(arg.substr("--max-size="sv.size())));
+        } else if (arg.substr(0, "--min-time-ms="sv.size()) == "--min-time-ms="sv) {
+            g_options.min_time_ns = std::stoll(std::string(arg.substr("--min-time-ms="sv.size()))) * 1'000'000;
+        } else {
+            std::cerr << "Unknown option: "sv << arg << std::endl;
+            std::exit(1);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    ParseOptions(argc, argv);
+    std::printf("%-48s %12s %12s %14s %14s %10s\n", "Benchmark", "ns/op", "allocs/iter", "bytes alloc", "bytes moved",
+                "iterations");
+    RunForType<int>();
+    RunForType<Pod64>();
+    RunForType<std::string>();
+    RunForType<Obj>();
+}
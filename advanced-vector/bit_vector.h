@@ -0,0 +1,266 @@
+#pragma once
+#include "vector.h"
+#include "vector_algorithms.h"
+
+#include <cstdint>
+#include <cstring>
+
+// Упакованный вектор флагов: 64 флага в слове RawMemory<uint64_t>.
+// Биты последнего слова за пределами Size() всегда равны нулю, поэтому подсчёт, поиск
+// и поразрядные операции работают сразу со словами целиком
+class BitVector {
+public:
+    using Word = uint64_t;
+    static constexpr size_t WORD_BITS = 64;
+
+    // Ссылка на отдельный бит
+    class Reference {
+    public:
+        Reference(Word* word, Word mask) noexcept
+        : word_(word)
+        , mask_(mask) {
+        }
+
+        operator bool() const noexcept {  // NOLINT
+            return (*word_ & mask_) != 0;
+        }
+        Reference& operator=(bool value) noexcept {
+            if (value) {
+                *word_ |= mask_;
+            } else {
+                *word_ &= ~mask_;
+            }
+            return *this;
+        }
+        Reference& operator=(const Reference& other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+        void Flip() noexcept {
+            *word_ ^= mask_;
+        }
+
+    private:
+        Word* word_;
+        Word mask_;
+    };
+
+    BitVector() = default;
+
+    explicit BitVector(size_t size, bool value = false)
+    : words_(WordCount(size))
+    , size_(size) {
+        for (size_t i = 0; i < WordCount(size); ++i) {
+            words_[i] = value ? ~Word{0} : Word{0};
+        }
+        ClearTail();
+    }
+
+    BitVector(const BitVector& other)
+    : words_(WordCount(other.size_))
+    , size_(other.size_) {
+        CopyWords(other);
+    }
+    BitVector(BitVector&& other) noexcept
+    : words_(std::move(other.words_))
+    , size_(std::exchange(other.size_, 0)) {
+    }
+
+    BitVector& operator=(const BitVector& rhs) {
+        if (this != &rhs) {
+            if (WordCount(rhs.size_) > words_.Capacity()) {
+                BitVector rhs_copy(rhs);
+                Swap(rhs_copy);
+            } else {
+                size_ = rhs.size_;
+                CopyWords(rhs);
+            }
+        }
+        return *this;
+    }
+    BitVector& operator=(BitVector&& rhs) noexcept {
+        if (this != &rhs) {
+            words_ = std::move(rhs.words_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    void Swap(BitVector& other) noexcept {
+        words_.Swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+    size_t Capacity() const noexcept {
+        return words_.Capacity() * WORD_BITS;
+    }
+
+    // Слова с упакованными флагами: флаг i хранится в бите i % 64 слова i / 64
+    const Word* Words() const noexcept {
+        return words_.GetAddress();
+    }
+    size_t WordCount() const noexcept {
+        return WordCount(size_);
+    }
+
+    bool operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return (words_[index / WORD_BITS] >> (index % WORD_BITS) & 1) != 0;
+    }
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return {words_ + index / WORD_BITS, Word{1} << (index % WORD_BITS)};
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<Word> new_words(WordCount(new_capacity));
+        CopyTrivially(words_.GetAddress(), WordCount(), new_words.GetAddress());
+        words_.Swap(new_words);
+    }
+
+    // Новые флаги получают значение value
+    void Resize(size_t new_size, bool value = false) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            const size_t old_size = size_;
+            const size_t old_words = WordCount();
+            size_ = new_size;
+            const Word fill = value ? ~Word{0} : Word{0};
+            if (old_size % WORD_BITS != 0) {
+                words_[old_words - 1] |= fill << (old_size % WORD_BITS);
+            }
+            for (size_t i = old_words; i < WordCount(); ++i) {
+                words_[i] = fill;
+            }
+        } else {
+            size_ = new_size;
+        }
+        ClearTail();
+    }
+
+    void Clear() noexcept {
+        size_ = 0;
+    }
+
+    void PushBack(bool value) {
+        if (size_ == Capacity()) {
+            Reserve(DoublingGrowth::NextCapacity(words_.Capacity(), sizeof(Word)) * WORD_BITS);
+        }
+        if (size_ % WORD_BITS == 0) {
+            words_[size_ / WORD_BITS] = 0;
+        }
+        ++size_;
+        (*this)[size_ - 1] = value;
+    }
+
+    void PopBack() noexcept {
+        if (size_ != 0) {
+            --size_;
+            ClearTail();
+        }
+    }
+
+    // Число установленных флагов
+    size_t Count() const noexcept {
+        return simd_detail::PopCountN(words_.GetAddress(), WordCount());
+    }
+
+    // Индекс первого установленного флага, начиная с from, либо Size(), если таких нет
+    size_t FindNext(size_t from) const noexcept {
+        if (from >= size_) {
+            return size_;
+        }
+        size_t word_index = from / WORD_BITS;
+        Word word = words_[word_index] & (~Word{0} << (from % WORD_BITS));
+        while (word == 0) {
+            if (++word_index == WordCount()) {
+                return size_;
+            }
+            word = words_[word_index];
+        }
+        return word_index * WORD_BITS + static_cast<size_t>(__builtin_ctzll(word));
+    }
+    size_t FindFirst() const noexcept {
+        return FindNext(0);
+    }
+
+    // Поразрядные операции над векторами одинакового размера выполняются словами
+    BitVector& operator&=(const BitVector& rhs) noexcept {
+        assert(size_ == rhs.size_);
+        for (size_t i = 0; i < WordCount(); ++i) {
+            words_[i] &= rhs.words_[i];
+        }
+        return *this;
+    }
+    BitVector& operator|=(const BitVector& rhs) noexcept {
+        assert(size_ == rhs.size_);
+        for (size_t i = 0; i < WordCount(); ++i) {
+            words_[i] |= rhs.words_[i];
+        }
+        return *this;
+    }
+    BitVector& operator^=(const BitVector& rhs) noexcept {
+        assert(size_ == rhs.size_);
+        for (size_t i = 0; i < WordCount(); ++i) {
+            words_[i] ^= rhs.words_[i];
+        }
+        return *this;
+    }
+    // Инвертирует все флаги
+    void Flip() noexcept {
+        for (size_t i = 0; i < WordCount(); ++i) {
+            words_[i] = ~words_[i];
+        }
+        ClearTail();
+    }
+
+    friend BitVector operator&(BitVector lhs, const BitVector& rhs) {
+        return lhs &= rhs;
+    }
+    friend BitVector operator|(BitVector lhs, const BitVector& rhs) {
+        return lhs |= rhs;
+    }
+    friend BitVector operator^(BitVector lhs, const BitVector& rhs) {
+        return lhs ^= rhs;
+    }
+
+    friend bool operator==(const BitVector& lhs, const BitVector& rhs) noexcept {
+        return lhs.size_ == rhs.size_ &&
+               (lhs.size_ == 0 ||
+                std::memcmp(lhs.words_.GetAddress(), rhs.words_.GetAddress(), lhs.WordCount() * sizeof(Word)) == 0);
+    }
+    friend bool operator!=(const BitVector& lhs, const BitVector& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    static size_t WordCount(size_t bits) noexcept {
+        return (bits + WORD_BITS - 1) / WORD_BITS;
+    }
+
+    void CopyWords(const BitVector& other) noexcept {
+        CopyTrivially(other.words_.GetAddress(), other.WordCount(), words_.GetAddress());
+    }
+
+    static void CopyTrivially(const Word* from, size_t n, Word* to) noexcept {
+        if (n != 0) {
+            std::memcpy(to, from, n * sizeof(Word));
+        }
+    }
+
+    // Обнуляет биты последнего слова за пределами размера
+    void ClearTail() noexcept {
+        if (size_ % WORD_BITS != 0) {
+            words_[size_ / WORD_BITS] &= ~Word{0} >> (WORD_BITS - size_ % WORD_BITS);
+        }
+    }
+
+private:
+    RawMemory<Word> words_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,254 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// Ограничения кеша освобождённых буферов одного потока
+struct BufferCacheLimits {
+    // Наибольшее число блоков в списке одного размерного класса
+    size_t max_blocks_per_class = 64;
+    // Наибольший суммарный размер блоков в кеше
+    size_t max_cached_bytes = size_t{8} << 20;
+};
+
+struct BufferCacheStats {
+    // Выделения, обслуженные из кеша и через operator new
+    size_t hits = 0;
+    size_t misses = 0;
+    // Выделения больше MAX_BLOCK_SIZE, которые не кешируются
+    size_t bypassed = 0;
+    // Освобождённые блоки, возвращённые в кеш и удалённые из-за ограничений
+    size_t returned = 0;
+    size_t dropped = 0;
+    size_t cached_bytes = 0;
+
+    double HitRate() const noexcept {
+        const size_t total = hits + misses;
+        return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+    }
+};
+
+// Кеш освобождённых блоков памяти со списками по размерным классам — степеням двойки
+// от MIN_BLOCK_SIZE до MAX_BLOCK_SIZE. Освобождённый блок помещается в начало списка своего класса,
+// поэтому повторное выделение того же размера сводится к извлечению указателя.
+// Объект не потокобезопасен: каждый поток использует свой кеш, см. GetThreadBufferCache
+class BufferCache {
+public:
+    static constexpr size_t MIN_BLOCK_SHIFT = 6;
+    static constexpr size_t MAX_BLOCK_SHIFT = 20;
+    static constexpr size_t MIN_BLOCK_SIZE = size_t{1} << MIN_BLOCK_SHIFT;
+    static constexpr size_t MAX_BLOCK_SIZE = size_t{1} << MAX_BLOCK_SHIFT;
+    static constexpr size_t CLASS_COUNT = MAX_BLOCK_SHIFT - MIN_BLOCK_SHIFT + 1;
+
+    BufferCache() = default;
+    explicit BufferCache(const BufferCacheLimits& limits) noexcept
+    : limits_(limits) {
+    }
+
+    BufferCache(const BufferCache&) = delete;
+    BufferCache& operator=(const BufferCache&) = delete;
+
+    ~BufferCache() {
+        Trim(0);
+    }
+
+    // Размер блока, который выделяется под bytes байт. Блоки одного класса взаимозаменяемы,
+    // поэтому они всегда выделяются полного размера, даже в обход кеша
+    static size_t BlockSize(size_t bytes) noexcept {
+        const size_t size_class = ClassOf(bytes);
+        return size_class != CLASS_COUNT ? ClassSize(size_class) : bytes;
+    }
+
+    void* Allocate(size_t bytes) {
+        const size_t size_class = ClassOf(bytes);
+        if (size_class == CLASS_COUNT) {
+            ++stats_.bypassed;
+            return ::operator new(bytes);
+        }
+        FreeList& list = lists_[size_class];
+        if (list.head == nullptr) {
+            ++stats_.misses;
+            return ::operator new(ClassSize(size_class));
+        }
+        ++stats_.hits;
+        FreeBlock* block = list.head;
+        list.head = block->next;
+        --list.count;
+        stats_.cached_bytes -= ClassSize(size_class);
+        return block;
+    }
+
+    // bytes должен совпадать с размером, переданным в Allocate
+    void Deallocate(void* p, size_t bytes) noexcept {
+        const size_t size_class = ClassOf(bytes);
+        if (size_class == CLASS_COUNT) {
+            ::operator delete(p, bytes);
+            return;
+        }
+        FreeList& list = lists_[size_class];
+        const size_t block_size = ClassSize(size_class);
+        if (list.count >= limits_.max_blocks_per_class || stats_.cached_bytes + block_size > limits_.max_cached_bytes) {
+            ++stats_.dropped;
+            ::operator delete(p, block_size);
+            return;
+        }
+        ++stats_.returned;
+        list.head = new (p) FreeBlock{list.head};
+        ++list.count;
+        stats_.cached_bytes += block_size;
+    }
+
+    // Освобождает кешированные блоки, начиная с больших, пока их суммарный размер больше max_bytes
+    void Trim(size_t max_bytes = 0) noexcept {
+        for (size_t size_class = CLASS_COUNT; size_class-- > 0 && stats_.cached_bytes > max_bytes;) {
+            FreeList& list = lists_[size_class];
+            while (list.head != nullptr && stats_.cached_bytes > max_bytes) {
+                FreeBlock* block = list.head;
+                list.head = block->next;
+                --list.count;
+                stats_.cached_bytes -= ClassSize(size_class);
+                ::operator delete(block, ClassSize(size_class));
+            }
+        }
+    }
+
+    // Новые ограничения сразу применяются к уже кешированным блокам
+    void SetLimits(const BufferCacheLimits& limits) noexcept {
+        limits_ = limits;
+        for (size_t size_class = 0; size_class < CLASS_COUNT; ++size_class) {
+            FreeList& list = lists_[size_class];
+            while (list.count > limits_.max_blocks_per_class) {
+                FreeBlock* block = list.head;
+                list.head = block->next;
+                --list.count;
+                stats_.cached_bytes -= ClassSize(size_class);
+                ::operator delete(block, ClassSize(size_class));
+            }
+        }
+        Trim(limits_.max_cached_bytes);
+    }
+    const BufferCacheLimits& GetLimits() const noexcept {
+        return limits_;
+    }
+
+    const BufferCacheStats& GetStats() const noexcept {
+        return stats_;
+    }
+    // Обнуляет счётчики, размер кешированных блоков сохраняется
+    void ResetStats() noexcept {
+        const size_t cached_bytes = stats_.cached_bytes;
+        stats_ = {};
+        stats_.cached_bytes = cached_bytes;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct FreeList {
+        FreeBlock* head = nullptr;
+        size_t count = 0;
+    };
+
+    // Номер класса либо CLASS_COUNT для блоков, которые не кешируются
+    static size_t ClassOf(size_t bytes) noexcept {
+        if (bytes > MAX_BLOCK_SIZE) {
+            return CLASS_COUNT;
+        }
+        if (bytes <= MIN_BLOCK_SIZE) {
+            return 0;
+        }
+        const size_t shift = 64 - static_cast<size_t>(__builtin_clzll(bytes - 1));
+        return shift - MIN_BLOCK_SHIFT;
+    }
+    static size_t ClassSize(size_t size_class) noexcept {
+        return MIN_BLOCK_SIZE << size_class;
+    }
+
+private:
+    FreeList lists_[CLASS_COUNT];
+    BufferCacheLimits limits_;
+    BufferCacheStats stats_;
+};
+
+namespace buffer_cache_detail {
+
+// Тривиально разрушаемый флаг остаётся доступным после уничтожения кеша потока,
+// поэтому контейнеры, уничтожаемые позже кеша, освобождают память напрямую
+inline thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCache {
+    ~ThreadCache() {
+        thread_cache_destroyed = true;
+    }
+
+    BufferCache cache;
+};
+
+inline BufferCache* FindThreadCache() noexcept {
+    if (thread_cache_destroyed) {
+        return nullptr;
+    }
+    thread_local ThreadCache thread_cache;
+    return &thread_cache.cache;
+}
+
+}  // namespace buffer_cache_detail
+
+// Кеш вызывающего потока: его ограничения, статистика и Trim.
+// Нельзя вызывать из деструкторов thread_local-объектов, уничтожаемых после кеша
+inline BufferCache& GetThreadBufferCache() noexcept {
+    BufferCache* cache = buffer_cache_detail::FindThreadCache();
+    assert(cache != nullptr);
+    return *cache;
+}
+
+// Аллокатор, берущий память из кеша текущего потока. Буфер можно освободить в другом потоке:
+// блок попадёт в кеш освобождающего потока. Все экземпляры взаимозаменяемы
+template <typename T>
+struct CachingAllocator {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "Use AlignedAllocator for over-aligned types");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = CachingAllocator<U>;
+    };
+
+    CachingAllocator() = default;
+    template <typename U>
+    CachingAllocator(const CachingAllocator<U>& /*other*/) noexcept {  // NOLINT
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if (BufferCache* cache = buffer_cache_detail::FindThreadCache()) {
+            return static_cast<T*>(cache->Allocate(bytes));
+        }
+        return static_cast<T*>(::operator new(BufferCache::BlockSize(bytes)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (BufferCache* cache = buffer_cache_detail::FindThreadCache()) {
+            cache->Deallocate(p, bytes);
+        } else {
+            ::operator delete(p, BufferCache::BlockSize(bytes));
+        }
+    }
+
+    bool operator==(const CachingAllocator& /*other*/) const noexcept {
+        return true;
+    }
+    bool operator!=(const CachingAllocator& /*other*/) const noexcept {
+        return false;
+    }
+};
@@ -0,0 +1,153 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+// Вектор, допускающий одновременное добавление элементов из многих потоков без блокировок.
+// Элементы хранятся в сегментах RawMemory, размеры которых — возрастающие степени двойки,
+// поэтому при росте ничего не переносится и адреса элементов не меняются.
+// Индекс нового элемента резервируется атомарным счётчиком, сегмент публикуется через CAS.
+// Чтение элемента по индексу не ждёт других потоков
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentVector {
+    static constexpr size_t FIRST_SEGMENT_SHIFT = 4;
+    static constexpr size_t MAX_SEGMENTS = 64 - FIRST_SEGMENT_SHIFT;
+
+    enum class SlotState : uint8_t {
+        EMPTY,
+        READY,
+        // Конструктор элемента выбросил исключение, индекс остаётся пропуском
+        FAILED,
+    };
+
+    struct Slot {
+        alignas(T) std::byte storage[sizeof(T)];
+        std::atomic<SlotState> state;
+
+        T* Get() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+
+public:
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Allocator& alloc)
+    : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    // Конструирует элемент в конце и возвращает его индекс. Может вызываться из разных потоков одновременно.
+    // Ссылки и указатели на элементы остаются действительными до уничтожения вектора
+    template <typename... Args>
+    size_t EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = SlotAt(index);
+        try {
+            new (slot.storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            slot.state.store(SlotState::FAILED, std::memory_order_release);
+            throw;
+        }
+        slot.state.store(SlotState::READY, std::memory_order_release);
+        return index;
+    }
+
+    size_t PushBack(const T& value) {
+        return EmplaceBack(value);
+    }
+    size_t PushBack(T&& value) {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Число зарезервированных индексов. Элементы с индексами меньше Size()
+    // могут ещё конструироваться другими потоками, это проверяет IsReady
+    size_t Size() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Элемент с индексом index полностью сконструирован.
+    // Если функция вернула true, операции над элементом в добавившем его потоке видны вызывающему
+    bool IsReady(size_t index) const noexcept {
+        if (index >= Size()) {
+            return false;
+        }
+        const Slot* slot = const_cast<ConcurrentVector&>(*this).FindSlot(index);
+        return slot != nullptr && slot->state.load(std::memory_order_acquire) == SlotState::READY;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+    T& operator[](size_t index) noexcept {
+        assert(IsReady(index));
+        return *FindSlot(index)->Get();
+    }
+
+    // Удаление элементов, как и уничтожение вектора, не должно пересекаться с другими операциями
+    ~ConcurrentVector() {
+        const size_t size = size_.load(std::memory_order_acquire);
+        for (size_t index = 0; index < size; ++index) {
+            Slot* slot = FindSlot(index);
+            if (slot != nullptr && slot->state.load(std::memory_order_relaxed) == SlotState::READY) {
+                std::destroy_at(slot->Get());
+            }
+        }
+    }
+
+private:
+    static size_t SegmentSize(size_t segment) noexcept {
+        return size_t{1} << (segment + FIRST_SEGMENT_SHIFT);
+    }
+
+    // Номер сегмента и позиция в нём. Сегмент k содержит индексы
+    // [2^(k + FIRST_SEGMENT_SHIFT) - 2^FIRST_SEGMENT_SHIFT, 2^(k + FIRST_SEGMENT_SHIFT + 1) - 2^FIRST_SEGMENT_SHIFT)
+    static std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t pos = index + SegmentSize(0);
+        const size_t high_bit = 63 - static_cast<size_t>(__builtin_clzll(pos));
+        const size_t segment = high_bit - FIRST_SEGMENT_SHIFT;
+        return {segment, pos - SegmentSize(segment)};
+    }
+
+    Slot* FindSlot(size_t index) noexcept {
+        const auto [segment, offset] = Locate(index);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        return slots != nullptr ? slots + offset : nullptr;
+    }
+
+    // Первый поток, которому понадобился сегмент, публикует его.
+    // Проигравшие гонку потоки освобождают свои сегменты
+    Slot& SlotAt(size_t index) {
+        const auto [segment, offset] = Locate(index);
+        assert(segment < MAX_SEGMENTS);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (slots == nullptr) {
+            RawMemory<Slot, SlotAllocator> memory(SegmentSize(segment), alloc_);
+            for (size_t i = 0; i < SegmentSize(segment); ++i) {
+                new (memory + i) Slot;
+                memory[i].state.store(SlotState::EMPTY, std::memory_order_relaxed);
+            }
+            if (segments_[segment].compare_exchange_strong(slots, memory.GetAddress(), std::memory_order_acq_rel,
+                                                           std::memory_order_acquire)) {
+                slots = memory.GetAddress();
+                storage_[segment] = std::move(memory);
+            }
+        }
+        return slots[offset];
+    }
+
+private:
+    SlotAllocator alloc_;
+    std::atomic<size_t> size_ = 0;
+    std::atomic<Slot*> segments_[MAX_SEGMENTS] = {};
+    // Владельцы памяти сегментов. Каждый элемент записывает только поток, опубликовавший сегмент
+    RawMemory<Slot, SlotAllocator> storage_[MAX_SEGMENTS];
+};
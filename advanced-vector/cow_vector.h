@@ -0,0 +1,227 @@
+#pragma once
+#include "vector.h"
+
+#include <atomic>
+#include <initializer_list>
+#include <utility>
+
+// Вектор с копированием при записи. Копии разделяют один буфер со счётчиком ссылок,
+// поэтому копирование выполняется за O(1), а буфер дублируется при первом изменении разделяемой копии.
+// Разные объекты CowVector с общим буфером можно использовать из разных потоков,
+// один объект — как и Vector, только из одного потока.
+// Ссылки и итераторы, полученные через неконстантный доступ, действительны
+// до следующего копирования вектора: запись через них после копирования изменит и копию
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class CowVector {
+    using Data = Vector<T, Allocator, GrowthPolicy>;
+
+    struct Shared {
+        template <typename... Args>
+        explicit Shared(Args&&... args)
+        : data(std::forward<Args>(args)...) {
+        }
+
+        std::atomic<size_t> refs = 1;
+        Data data;
+    };
+
+public:
+    using iterator = typename Data::iterator;
+    using const_iterator = typename Data::const_iterator;
+
+    CowVector() = default;
+
+    explicit CowVector(size_t size)
+    : shared_(new Shared(size)) {
+    }
+    CowVector(std::initializer_list<T> init)
+    : shared_(new Shared(init)) {
+    }
+    explicit CowVector(Data data)
+    : shared_(new Shared(std::move(data))) {
+    }
+
+    CowVector(const CowVector& other) noexcept
+    : shared_(other.shared_) {
+        if (shared_ != nullptr) {
+            shared_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    CowVector(CowVector&& other) noexcept
+    : shared_(std::exchange(other.shared_, nullptr)) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        CowVector rhs_copy(rhs);
+        Swap(rhs_copy);
+        return *this;
+    }
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        CowVector tmp(std::move(rhs));
+        Swap(tmp);
+        return *this;
+    }
+
+    ~CowVector() {
+        Release();
+    }
+
+    void Swap(CowVector& other) noexcept {
+        std::swap(shared_, other.shared_);
+    }
+
+    // Буфер разделён с другими копиями
+    bool IsShared() const noexcept {
+        return shared_ != nullptr && shared_->refs.load(std::memory_order_acquire) > 1;
+    }
+
+    // Чтение не копирует буфер
+
+    size_t Size() const noexcept {
+        return shared_ != nullptr ? shared_->data.Size() : 0;
+    }
+    size_t Capacity() const noexcept {
+        return shared_ != nullptr ? shared_->data.Capacity() : 0;
+    }
+    const T& operator[](size_t index) const noexcept {
+        assert(shared_ != nullptr);
+        return std::as_const(shared_->data)[index];
+    }
+    const_iterator begin() const noexcept {
+        return shared_ != nullptr ? std::as_const(shared_->data).begin() : nullptr;
+    }
+    const_iterator end() const noexcept {
+        return shared_ != nullptr ? std::as_const(shared_->data).end() : nullptr;
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+    // Содержимое только для чтения, например чтобы передать его функциям, принимающим const Vector&
+    const Data& Get() const {
+        static const Data EMPTY;
+        return shared_ != nullptr ? shared_->data : EMPTY;
+    }
+
+    // Изменяющие операции сначала получают собственную копию буфера
+
+    T& operator[](size_t index) {
+        return Mutable()[index];
+    }
+    iterator begin() {
+        return Mutable().begin();
+    }
+    iterator end() {
+        return Mutable().end();
+    }
+
+    void Reserve(size_t new_capacity) {
+        Mutable().Reserve(new_capacity);
+    }
+    void Resize(size_t new_size) {
+        Mutable().Resize(new_size);
+    }
+    void Resize(size_t new_size, const T& value) {
+        PreviousBuffer previous;
+        Mutable(previous).Resize(new_size, value);
+    }
+    void Clear() {
+        if (IsShared()) {
+            // Разделяемые элементы не копируются, чтобы сразу удалить копию
+            CowVector empty;
+            Swap(empty);
+        } else if (shared_ != nullptr) {
+            shared_->data.Clear();
+        }
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        // Аргументы могут ссылаться на элементы разделяемого буфера: он не меняется и не освобождается до конца вызова
+        PreviousBuffer previous;
+        return Mutable(previous).EmplaceBack(std::forward<Args>(args)...);
+    }
+    void PopBack() {
+        Mutable().PopBack();
+    }
+
+    // Позиции могут указывать в разделяемый буфер, поэтому пересчитываются в индексы
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t index = pos - cbegin();
+        PreviousBuffer previous;
+        Data& data = Mutable(previous);
+        return data.Emplace(data.cbegin() + index, std::forward<Args>(args)...);
+    }
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+    iterator Erase(const_iterator pos) {
+        const size_t index = pos - cbegin();
+        Data& data = Mutable();
+        return data.Erase(data.cbegin() + index);
+    }
+    iterator Erase(const_iterator first, const_iterator last) {
+        const size_t first_index = first - cbegin();
+        const size_t last_index = last - cbegin();
+        Data& data = Mutable();
+        return data.Erase(data.cbegin() + first_index, data.cbegin() + last_index);
+    }
+
+private:
+    static void Unref(Shared* shared) noexcept {
+        if (shared != nullptr && shared->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete shared;
+        }
+    }
+
+    // Ссылка на разделяемый буфер, от которого отделился вектор. Держится до конца операции,
+    // чтобы аргументы, ссылающиеся на этот буфер, оставались действительными, даже если
+    // другой поток тем временем уничтожит остальные копии
+    struct PreviousBuffer {
+        PreviousBuffer() = default;
+        PreviousBuffer(const PreviousBuffer&) = delete;
+        PreviousBuffer& operator=(const PreviousBuffer&) = delete;
+
+        ~PreviousBuffer() {
+            Unref(shared);
+        }
+
+        Shared* shared = nullptr;
+    };
+
+    // Возвращает вектор, принадлежащий только этому объекту, копируя разделяемый буфер.
+    // Ссылка на прежний буфер передаётся в previous
+    Data& Mutable(PreviousBuffer& previous) {
+        if (shared_ == nullptr) {
+            shared_ = new Shared();
+        } else if (shared_->refs.load(std::memory_order_acquire) > 1) {
+            auto copy = new Shared(shared_->data);
+            previous.shared = std::exchange(shared_, copy);
+        }
+        return shared_->data;
+    }
+    // Для операций, аргументы которых не ссылаются на элементы
+    Data& Mutable() {
+        PreviousBuffer previous;
+        return Mutable(previous);
+    }
+
+    void Release() noexcept {
+        Unref(std::exchange(shared_, nullptr));
+    }
+
+private:
+    Shared* shared_ = nullptr;
+};
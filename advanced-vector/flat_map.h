@@ -0,0 +1,316 @@
+#pragma once
+#include "soa_vector.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+// Тег конструктора, принимающего уже отсортированные ключи без повторов
+struct SortedUniqueTag {};
+inline constexpr SortedUniqueTag SORTED_UNIQUE{};
+
+namespace flat_detail {
+
+// Индекс первого ключа, не меньшего key. Цикл выполняет одинаковое число шагов для всех ключей,
+// а выбор половины компилируется в условное перемещение, поэтому поиск не зависит от предсказания ветвлений
+template <typename K, typename Compare>
+size_t LowerBound(const K* keys, size_t size, const K& key, const Compare& less) {
+    if (size == 0) {
+        return 0;
+    }
+    const K* base = keys;
+    while (size > 1) {
+        const size_t half = size / 2;
+        base = less(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<size_t>(base - keys) + (less(*base, key) ? 1 : 0);
+}
+
+template <typename K, typename Compare>
+bool IsSortedUnique(const K* keys, size_t size, const Compare& less) {
+    for (size_t i = 1; i < size; ++i) {
+        if (!less(keys[i - 1], keys[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace flat_detail
+
+// Множество, хранящее ключи в отсортированном Vector. Поиск двоичный, вставка и удаление
+// сдвигают хвост вектора, поэтому подходит для небольших таблиц, которые чаще читаются, чем меняются.
+// Итераторы и ссылки становятся недействительными после любого изменения
+template <typename K, typename Compare = std::less<K>, typename Allocator = std::allocator<K>>
+class FlatSet {
+public:
+    using Keys = Vector<K, Allocator>;
+    using iterator = const K*;
+    using const_iterator = const K*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& less)
+    : less_(less) {
+    }
+
+    // Сортирует ключи один раз и удаляет повторы
+    explicit FlatSet(Keys keys, const Compare& less = Compare())
+    : keys_(std::move(keys))
+    , less_(less) {
+        std::sort(keys_.begin(), keys_.end(), less_);
+        const auto last = std::unique(keys_.begin(), keys_.end(), [this](const K& lhs, const K& rhs) {
+            return !less_(lhs, rhs);
+        });
+        keys_.Erase(last, keys_.end());
+    }
+    FlatSet(std::initializer_list<K> init, const Compare& less = Compare())
+    : FlatSet(Keys(init), less) {
+    }
+    FlatSet(SortedUniqueTag, Keys keys, const Compare& less = Compare())
+    : keys_(std::move(keys))
+    , less_(less) {
+        assert(flat_detail::IsSortedUnique(keys_.begin(), keys_.Size(), less_));
+    }
+
+    const_iterator begin() const noexcept {
+        return keys_.begin();
+    }
+    const_iterator end() const noexcept {
+        return keys_.end();
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+    const Keys& GetKeys() const noexcept {
+        return keys_;
+    }
+
+    const_iterator LowerBound(const K& key) const {
+        return keys_.begin() + flat_detail::LowerBound(keys_.begin(), keys_.Size(), key, less_);
+    }
+    const_iterator Find(const K& key) const {
+        const const_iterator it = LowerBound(key);
+        return it != end() && !less_(key, *it) ? it : end();
+    }
+    bool Contains(const K& key) const {
+        return Find(key) != end();
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+    }
+    void Clear() noexcept {
+        keys_.Clear();
+    }
+
+    // Возвращает позицию ключа и признак того, что он был добавлен
+    std::pair<const_iterator, bool> Insert(const K& key) {
+        return InsertKey(key);
+    }
+    std::pair<const_iterator, bool> Insert(K&& key) {
+        return InsertKey(std::move(key));
+    }
+
+    // Возвращает число удалённых ключей
+    size_t Erase(const K& key) {
+        const const_iterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        keys_.Erase(it);
+        return 1;
+    }
+    const_iterator Erase(const_iterator pos) {
+        return keys_.Erase(pos);
+    }
+
+private:
+    template <typename Key>
+    std::pair<const_iterator, bool> InsertKey(Key&& key) {
+        const const_iterator it = LowerBound(key);
+        if (it != end() && !less_(key, *it)) {
+            return {it, false};
+        }
+        return {keys_.Emplace(it, std::forward<Key>(key)), true};
+    }
+
+private:
+    Keys keys_;
+    Compare less_;
+};
+
+// Отображение на двух Vector: отсортированных ключей и значений с тем же индексом.
+// Поиск просматривает только массив ключей, поэтому значения не вытесняют ключи из кеша.
+// Итераторы, ссылки и индексы становятся недействительными после вставки и удаления
+template <typename K, typename V, typename Compare = std::less<K>, typename KeyAllocator = std::allocator<K>,
+          typename ValueAllocator = std::allocator<V>>
+class FlatMap {
+public:
+    using Keys = Vector<K, KeyAllocator>;
+    using Values = Vector<V, ValueAllocator>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& less)
+    : less_(less) {
+    }
+
+    // Сортирует пары по ключу один раз. Из пар с одинаковыми ключами остаётся первая
+    FlatMap(Keys keys, Values values, const Compare& less = Compare())
+    : less_(less) {
+        assert(keys.Size() == values.Size());
+        Vector<size_t> order(keys.Size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&keys, this](size_t lhs, size_t rhs) {
+            return less_(keys[lhs], keys[rhs]);
+        });
+        keys_.Reserve(keys.Size());
+        values_.Reserve(values.Size());
+        for (const size_t index : order) {
+            if (keys_.Size() != 0 && !less_(keys_[keys_.Size() - 1], keys[index])) {
+                continue;
+            }
+            keys_.PushBack(std::move(keys[index]));
+            values_.PushBack(std::move(values[index]));
+        }
+    }
+    FlatMap(std::initializer_list<std::pair<K, V>> init, const Compare& less = Compare())
+    : FlatMap(SplitPairs(init), less) {
+    }
+    FlatMap(SortedUniqueTag, Keys keys, Values values, const Compare& less = Compare())
+    : keys_(std::move(keys))
+    , values_(std::move(values))
+    , less_(less) {
+        assert(keys_.Size() == values_.Size());
+        assert(flat_detail::IsSortedUnique(keys_.begin(), keys_.Size(), less_));
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    // Ключи и значения с одинаковыми индексами образуют пары
+    const Keys& GetKeys() const noexcept {
+        return keys_;
+    }
+    Span<V> GetValues() noexcept {
+        return {values_.begin(), values_.Size()};
+    }
+    Span<const V> GetValues() const noexcept {
+        return {values_.begin(), values_.Size()};
+    }
+
+    // Индекс первого ключа, не меньшего key
+    size_t LowerBound(const K& key) const {
+        return flat_detail::LowerBound(keys_.begin(), keys_.Size(), key, less_);
+    }
+    // Возвращает nullptr, если ключа нет
+    V* Find(const K& key) {
+        const size_t index = IndexOf(key);
+        return index != Size() ? &values_[index] : nullptr;
+    }
+    const V* Find(const K& key) const {
+        return const_cast<FlatMap&>(*this).Find(key);
+    }
+    bool Contains(const K& key) const {
+        return IndexOf(key) != Size();
+    }
+    V& At(const K& key) {
+        if (V* value = Find(key)) {
+            return *value;
+        }
+        throw std::out_of_range("FlatMap::At: key not found");
+    }
+    const V& At(const K& key) const {
+        return const_cast<FlatMap&>(*this).At(key);
+    }
+    // Добавляет значение, инициализированное по умолчанию, если ключа нет
+    V& operator[](const K& key) {
+        return TryEmplace(key).first;
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+        values_.Reserve(new_capacity);
+    }
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    // Создаёт значение из args, если ключа нет. Возвращает значение ключа и признак вставки.
+    // Если создание значения выбросит исключение, отображение не меняется
+    template <typename... Args>
+    std::pair<V&, bool> TryEmplace(const K& key, Args&&... args) {
+        const size_t index = LowerBound(key);
+        if (index != Size() && !less_(key, keys_[index])) {
+            return {values_[index], false};
+        }
+        values_.Emplace(values_.begin() + index, std::forward<Args>(args)...);
+        try {
+            keys_.Emplace(keys_.begin() + index, key);
+        } catch (...) {
+            values_.Erase(values_.begin() + index);
+            throw;
+        }
+        return {values_[index], true};
+    }
+    bool Insert(const K& key, const V& value) {
+        return TryEmplace(key, value).second;
+    }
+    bool Insert(const K& key, V&& value) {
+        return TryEmplace(key, std::move(value)).second;
+    }
+    // Заменяет значение существующего ключа
+    void InsertOrAssign(const K& key, V value) {
+        auto [stored, inserted] = TryEmplace(key, std::move(value));
+        if (!inserted) {
+            stored = std::move(value);
+        }
+    }
+
+    // Возвращает число удалённых пар
+    size_t Erase(const K& key) {
+        const size_t index = IndexOf(key);
+        if (index == Size()) {
+            return 0;
+        }
+        keys_.Erase(keys_.begin() + index);
+        values_.Erase(values_.begin() + index);
+        return 1;
+    }
+
+private:
+    FlatMap(std::pair<Keys, Values> split, const Compare& less)
+    : FlatMap(std::move(split.first), std::move(split.second), less) {
+    }
+
+    static std::pair<Keys, Values> SplitPairs(std::initializer_list<std::pair<K, V>> init) {
+        std::pair<Keys, Values> split;
+        split.first.Reserve(init.size());
+        split.second.Reserve(init.size());
+        for (const auto& [key, value] : init) {
+            split.first.PushBack(key);
+            split.second.PushBack(value);
+        }
+        return split;
+    }
+
+    // Индекс ключа либо Size(), если ключа нет
+    size_t IndexOf(const K& key) const {
+        const size_t index = LowerBound(key);
+        return index != Size() && !less_(key, keys_[index]) ? index : Size();
+    }
+
+private:
+    Keys keys_;
+    Values values_;
+    Compare less_;
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Аллокатор для очень больших векторов (Linux). Блоки от ThresholdBytes и больше
+// отображаются через mmap на большие страницы, что сокращает промахи TLB и число page fault.
+// Меньшие блоки выделяются через std::allocator.
+// Освобождённый блок сразу возвращается системе через munmap.
+// Подключается как аллокатор вектора: Vector<T, HugePageAllocator<T>>
+
+// Флаги HugePageAllocator, объединяемые через |
+enum HugePageFlags : unsigned {
+    // Прозрачные большие страницы: обычное отображение с madvise(MADV_HUGEPAGE)
+    HUGE_PAGES_TRANSPARENT = 0,
+    // Сначала пробовать MAP_HUGETLB из заранее зарезервированного пула,
+    // а если пул пуст, использовать прозрачные большие страницы
+    HUGE_PAGES_EXPLICIT = 1,
+    // Заранее отобразить все страницы блока (MAP_POPULATE), чтобы не платить за page fault
+    // при первом обращении
+    HUGE_PAGES_POPULATE = 2,
+};
+
+inline constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+// Наименьший размер обычной страницы, используемый как шаг при заполнении блока
+inline constexpr size_t SMALL_PAGE_SIZE = 4096;
+
+template <typename T, size_t ThresholdBytes = (size_t{32} << 20), unsigned Flags = HUGE_PAGES_TRANSPARENT>
+struct HugePageAllocator {
+    static_assert(alignof(T) <= HUGE_PAGE_SIZE);
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, ThresholdBytes, Flags>;
+    };
+
+    HugePageAllocator() = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, ThresholdBytes, Flags>& /*other*/) noexcept {  // NOLINT
+    }
+
+    T* allocate(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - 2 * HUGE_PAGE_SIZE) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if (!IsMapped(n)) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(Map(MappingSize(n)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (!IsMapped(n)) {
+            std::allocator<T>().deallocate(p, n);
+        } else {
+            munmap(p, MappingSize(n));
+        }
+    }
+
+    // Блок из n элементов отображается через mmap
+    static bool IsMapped(size_t n) noexcept {
+        return n * sizeof(T) >= ThresholdBytes;
+    }
+
+    bool operator==(const HugePageAllocator& /*other*/) const noexcept {
+        return true;
+    }
+    bool operator!=(const HugePageAllocator& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    // Длина отображения кратна большой странице, поэтому munmap освобождает блок независимо
+    // от того, какими страницами он был отображён
+    static size_t MappingSize(size_t n) noexcept {
+        return (n * sizeof(T) + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+
+    static void* Map(size_t size) {
+        const int populate = (Flags & HUGE_PAGES_POPULATE) != 0 ? MAP_POPULATE : 0;
+        if constexpr ((Flags & HUGE_PAGES_EXPLICIT) != 0) {
+            void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate,
+                           -1, 0);
+            if (p != MAP_FAILED) {
+                return p;
+            }
+        }
+
+        // Ядро выделяет прозрачные большие страницы только в выровненных по ним диапазонах,
+        // поэтому отображается запас в одну страницу, а невыровненные края отрезаются
+        void* raw = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+        const uintptr_t aligned = (begin + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        if (aligned != begin) {
+            munmap(raw, aligned - begin);
+        }
+        if (const size_t tail = HUGE_PAGE_SIZE - (aligned - begin); tail != 0) {
+            munmap(reinterpret_cast<void*>(aligned + size), tail);
+        }
+
+        void* p = reinterpret_cast<void*>(aligned);
+        madvise(p, size, MADV_HUGEPAGE);
+        if (populate != 0) {
+            // MAP_POPULATE при mmap отобразил бы и отрезанные края, поэтому страницы
+            // заполняются после выравнивания
+#ifdef MADV_POPULATE_WRITE
+            if (madvise(p, size, MADV_POPULATE_WRITE) == 0) {
+                return p;
+            }
+#endif
+            for (size_t offset = 0; offset < size; offset += SMALL_PAGE_SIZE) {
+                static_cast<volatile std::byte*>(p)[offset] = std::byte{0};
+            }
+        }
+        return p;
+    }
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// Итератор произвольного доступа для контейнеров, элементы которых адресуются индексом:
+// разыменование вызывает operator[] контейнера Owner. Для константного итератора Owner — константный тип.
+// Pointer — void, если operator[] возвращает прокси-объект вместо ссылки
+template <typename Owner, typename Value, typename Reference, typename Pointer>
+class IndexIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using reference = Reference;
+    using pointer = Pointer;
+
+    IndexIterator() = default;
+    IndexIterator(Owner* owner, size_t index) noexcept
+    : owner_(owner)
+    , index_(index) {
+    }
+    // Неконстантный итератор приводится к константному
+    template <typename OtherOwner, typename OtherReference, typename OtherPointer,
+              typename = std::enable_if_t<std::is_same_v<const OtherOwner, Owner> && !std::is_same_v<OtherOwner, Owner>>>
+    IndexIterator(const IndexIterator<OtherOwner, Value, OtherReference, OtherPointer>& other) noexcept  // NOLINT
+    : owner_(other.owner_)
+    , index_(other.index_) {
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+    template <typename P = Pointer, typename = std::enable_if_t<!std::is_void_v<P>>>
+    P operator->() const noexcept {
+        return std::addressof(**this);
+    }
+    reference operator[](difference_type offset) const noexcept {
+        return *(*this + offset);
+    }
+
+    IndexIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+    IndexIterator operator++(int) noexcept {
+        return IndexIterator(owner_, index_++);
+    }
+    IndexIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+    IndexIterator operator--(int) noexcept {
+        return IndexIterator(owner_, index_--);
+    }
+    IndexIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+    IndexIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+    friend IndexIterator operator+(IndexIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+    friend IndexIterator operator+(difference_type offset, IndexIterator it) noexcept {
+        return it += offset;
+    }
+    friend IndexIterator operator-(IndexIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+    friend difference_type operator-(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    // Сравниваются только индексы: итераторы разных контейнеров сравнивать нельзя
+    friend bool operator==(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+    friend bool operator!=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ != rhs.index_;
+    }
+    friend bool operator<(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ < rhs.index_;
+    }
+    friend bool operator>(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ > rhs.index_;
+    }
+    friend bool operator<=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ <= rhs.index_;
+    }
+    friend bool operator>=(const IndexIterator& lhs, const IndexIterator& rhs) noexcept {
+        return lhs.index_ >= rhs.index_;
+    }
+
+private:
+    template <typename, typename, typename, typename>
+    friend class IndexIterator;
+
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
@@ -1,8 +1,26 @@
+#include "bit_vector.h"
+#include "caching_allocator.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "huge_page_allocator.h"
+#include "mapped_vector.h"
+#include "numa_allocator.h"
+#include "segmented_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "static_vector.h"
 #include "vector.h"
+#include "vector_algorithms.h"
+#include "vector_io.h"
 
+#include <atomic>
 #include <iostream>
+#include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -116,8 +134,94 @@ struct Obj {
     static inline int num_move_assigned = 0;
 };
 
+// Владеющий указателем тип: не является тривиально копируемым,
+// но его можно переносить в новую память побайтово
+struct Handle {
+    Handle() = default;
+    explicit Handle(int value)
+        : ptr(new int(value))  //
+    {
+    }
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+    Handle(Handle&& other) noexcept
+        : ptr(std::exchange(other.ptr, nullptr))  //
+    {
+        ++num_moved;
+    }
+    Handle& operator=(Handle&& other) noexcept {
+        std::swap(ptr, other.ptr);
+        ++num_moved;
+        return *this;
+    }
+    ~Handle() {
+        delete ptr;
+    }
+
+    int* ptr = nullptr;
+
+    static inline int num_moved = 0;
+};
+
+struct AllocationCounters {
+    static void Reset() {
+        num_allocations = 0;
+        num_deallocations = 0;
+    }
+
+    static inline int num_allocations = 0;
+    static inline int num_deallocations = 0;
+};
+
+// Аллокатор с состоянием: память, выделенная аллокатором с одним id,
+// должна освобождаться аллокатором с тем же id
+template <typename T, bool Propagate = false>
+struct CountingAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+    template <typename U>
+    struct rebind {
+        using other = CountingAllocator<U, Propagate>;
+    };
+
+    CountingAllocator() = default;
+    explicit CountingAllocator(int id) noexcept
+        : id(id)  //
+    {
+    }
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U, Propagate>& other) noexcept  // NOLINT
+        : id(other.id)  //
+    {
+    }
+
+    T* allocate(size_t n) {
+        ++AllocationCounters::num_allocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        ++AllocationCounters::num_deallocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    bool operator==(const CountingAllocator& other) const noexcept {
+        return id == other.id;
+    }
+    bool operator!=(const CountingAllocator& other) const noexcept {
+        return id != other.id;
+    }
+
+    int id = 0;
+};
+
 }  // namespace
 
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -558,84 +662,1938 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    const size_t SIZE = 1000;
+    static_assert(IS_TRIVIALLY_RELOCATABLE<int>);
+    static_assert(!IS_TRIVIALLY_RELOCATABLE<Obj>);
+    static_assert(IS_TRIVIALLY_RELOCATABLE<Handle>);
+    {
+        Vector<int> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        v.Insert(v.cbegin() + SIZE / 2, -1);
+        v.Reserve(v.Capacity() * 2);
+        assert(v.Size() == SIZE + 1);
+        assert(v[SIZE / 2] == -1);
+        for (size_t i = 0; i < SIZE / 2; ++i) {
+            assert(v[i] == static_cast<int>(i));
+            assert(v[SIZE - i] == static_cast<int>(SIZE - i - 1));
+        }
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    {
+        Handle::num_moved = 0;
+        Vector<Handle> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Reserve(SIZE * 4);
+        // Перенос при реаллокации выполняется побайтово, без вызова конструктора перемещения
+        assert(Handle::num_moved == 0);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(*v[i].ptr == static_cast<int>(i));
+        }
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+}
+
+void Test8() {
+    const size_t SIZE = 100;
+#ifndef ADVANCED_VECTOR_STATS
+    static_assert(sizeof(Vector<int>) == sizeof(int*) + 2 * sizeof(size_t));
+#endif
+    {
+        using Alloc = CountingAllocator<int>;
+        AllocationCounters::Reset();
+        {
+            Vector<int, Alloc> v(SIZE, Alloc{1});
+            assert(v.GetAllocator().id == 1);
+            v.PushBack(1);
+            assert(AllocationCounters::num_allocations == 2);
+            assert(AllocationCounters::num_deallocations == 1);
+
+            // Непередаваемый аллокатор остаётся у вектора при присваивании
+            Vector<int, Alloc> other(Alloc{2});
+            other = v;
+            assert(other.GetAllocator().id == 2);
+            assert(other.Size() == SIZE + 1);
+            other = std::move(v);
+            assert(other.GetAllocator().id == 2);
+            assert(other.Size() == SIZE + 1);
+            assert(other[SIZE] == 1);
+
+            const Vector<int, Alloc> copy(other);
+            assert(copy.GetAllocator().id == 2);
+        }
+        assert(AllocationCounters::num_allocations == AllocationCounters::num_deallocations);
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+    {
+        using Alloc = CountingAllocator<Obj, true>;
+        Obj::ResetCounters();
+        AllocationCounters::Reset();
+        {
+            Vector<Obj, Alloc> v(SIZE, Alloc{1});
+            Vector<Obj, Alloc> other(SIZE / 2, Alloc{2});
+            other = v;
+            assert(other.GetAllocator().id == 1);
+            assert(other.Size() == SIZE);
+
+            Vector<Obj, Alloc> moved(Alloc{3});
+            const int old_num_moved = Obj::num_moved;
+            moved = std::move(other);
+            assert(moved.GetAllocator().id == 1);
+            assert(Obj::num_moved == old_num_moved);
+
+            Vector<Obj, Alloc> swapped(Alloc{4});
+            swapped.Swap(moved);
+            assert(swapped.GetAllocator().id == 1);
+            assert(moved.GetAllocator().id == 4);
+            assert(swapped.Size() == SIZE);
         }
-        return *this;
+        assert(Obj::GetAliveObjectCount() == 0);
+        assert(AllocationCounters::num_allocations == AllocationCounters::num_deallocations);
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+}
+
+void Test9() {
+    const size_t SIZE = 100'000;
+    static_assert(HasReallocate<MallocAllocator<uint64_t>>::value);
+    static_assert(!HasReallocate<std::allocator<uint64_t>>::value);
+    {
+        Vector<uint64_t, MallocAllocator<uint64_t>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == SIZE);
+        v.Reserve(SIZE * 3);
+        assert(v.Capacity() == SIZE * 3);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(v[i] == i);
+        }
+    }
+    {
+        Vector<uint64_t, MallocAllocator<uint64_t>> v(1);
+        v[0] = 42;
+        // Вставка существующего элемента должна быть безопасна и при реаллокации через realloc
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin(), v[1]);
+        assert(v.Size() == 3);
+        assert(v[0] == 42 && v[1] == 42 && v[2] == 42);
+        v.EmplaceBack(1);
+        v.Insert(v.cbegin() + 1, 7);
+        assert(v.Size() == 5);
+        assert(v[1] == 7 && v[4] == 1);
     }
-    ~C() {
-        ++dtor;
+    {
+        Vector<Handle, MallocAllocator<Handle>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.Emplace(v.cbegin(), i);
+        }
+        for (int i = 0; i < 100; ++i) {
+            assert(*v[i].ptr == 99 - i);
+        }
     }
+}
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
-    }
-
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+void Test10() {
+    {
+        Vector<int, std::allocator<int>, GeometricGrowth<>> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+            if (capacities.empty() || capacities.back() != v.Capacity()) {
+                capacities.push_back(v.Capacity());
+            }
+        }
+        assert((capacities == std::vector<size_t>{1, 2, 3, 4, 6, 9, 13}));
+    }
+    {
+        Vector<int, std::allocator<int>, MinCapacityGrowth<8>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == 8);
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 16);
+    }
+    {
+        Vector<uint32_t, std::allocator<uint32_t>, CacheLineGrowth<>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == CACHE_LINE_SIZE / sizeof(uint32_t));
+    }
+    {
+        struct Triple {
+            uint32_t a, b, c;
+        };
+        assert(SizeClassGrowth<>::NextCapacity(0, sizeof(Triple)) == 1);
+        // 6 * 12 = 72 байта округляются до 128
+        assert(SizeClassGrowth<>::NextCapacity(3, sizeof(Triple)) == 128 / sizeof(Triple));
+        assert(SizeClassGrowth<>::NextCapacity(1000, sizeof(Triple)) == 24576 / sizeof(Triple));
+    }
+    {
+        using Growth = LinearGrowthAfter<1024>;
+        assert(Growth::NextCapacity(64, sizeof(int)) == 128);
+        assert(Growth::NextCapacity(256, sizeof(int)) == 512);
+        assert(Growth::NextCapacity(512, sizeof(int)) == 768);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj, std::allocator<Obj>, GeometricGrowth<>> v(10);
+        v.EmplaceBack(1);
+        v.Insert(v.cbegin(), Obj{2});
+        assert(v.Capacity() == 15);
+        assert(v.Size() == 12);
+        assert(v[0].id == 2 && v[11].id == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test11() {
+    const size_t N = 8;
+    const size_t SIZE = 100;
+    {
+        SmallVector<int, N> v;
+        assert(v.Capacity() == N);
+        for (size_t i = 0; i < N; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v.IsInline());
+        v.PushBack(static_cast<int>(N));
+        assert(!v.IsInline());
+        assert(v.Capacity() == N * 2);
+        for (size_t i = 0; i <= N; ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+    }
+    Obj::ResetCounters();
+    {
+        Obj::default_construction_throw_countdown = SIZE / 2;
+        try {
+            SmallVector<Obj, N> v(SIZE);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    Obj::ResetCounters();
+    {
+        SmallVector<Obj, N> v(N / 2);
+        v[1].throw_on_copy = true;
+        try {
+            SmallVector<Obj, N> v_copy(v);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+            assert(Obj::num_copied == 1);
+        }
+        assert(Obj::GetAliveObjectCount() == N / 2);
+    }
+    Obj::ResetCounters();
+    {
+        SmallVector<Obj, N> v(N);
+        v.PushBack(Obj{1});
+        assert(Obj::num_moved == N + 1);
+        assert(Obj::num_copied == 0);
+        v.Insert(v.cbegin() + 2, Obj{2});
+        v.EmplaceBack(3, "Ivan");
+        v.Erase(v.cbegin());
+        assert(v.Size() == N + 2);
+        assert(v[1].id == 2 && v[N].id == 1 && v[N + 1].name == "Ivan");
+        v.Resize(N / 2);
+        v.PopBack();
+        assert(Obj::GetAliveObjectCount() == N / 2 - 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<TestObj, 1> v(1);
+        // Вставка собственного элемента должна быть безопасна и при переходе в кучу
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin(), v[1]);
+        v.Emplace(v.cbegin() + 1, std::move(v[2]));
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+    Obj::ResetCounters();
+    {
+        SmallVector<Obj, N> small(N / 2);
+        SmallVector<Obj, N> large(SIZE);
+        small[0].id = 1;
+        large[0].id = 2;
+        const Obj* large_data = &large[0];
+
+        SmallVector<Obj, N> moved_large(std::move(large));
+        assert(&moved_large[0] == large_data);
+        SmallVector<Obj, N> moved_small(std::move(small));
+        assert(moved_small.IsInline() && moved_small[0].id == 1);
+        assert(small.Size() == 0 && large.Size() == 0);
+
+        moved_small.Swap(moved_large);
+        assert(moved_small.Size() == SIZE && moved_small[0].id == 2);
+        assert(moved_large.Size() == N / 2 && moved_large[0].id == 1);
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+        moved_large = moved_small;
+        assert(moved_large.Size() == SIZE && moved_large[0].id == 2);
+        moved_small = SmallVector<Obj, N>(1);
+        assert(moved_small.Size() == 1 && moved_small.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE + 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+void Test12() {
+    const size_t SIZE = 10;
+    {
+        Vector<int> v{1, 2, 3};
+        assert(v.Size() == 3 && v.Capacity() == 3);
+        const std::vector<int> source{4, 5, 6, 7};
+        v.Append(source.begin(), source.end());
+        assert(v.Size() == 7 && v.Capacity() == 7);
+        auto pos = v.Insert(v.cbegin() + 1, source.begin(), source.begin() + 2);
+        assert(pos == v.begin() + 1);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 4, 5, 2, 3, 4, 5, 6, 7}));
+        v.Insert(v.cbegin(), 2, v[8]);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{7, 7, 1, 4, 5, 2, 3, 4, 5, 6, 7}));
+
+        std::istringstream input("8 9");
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert(v.Size() == 13 && v[1] == 8 && v[2] == 9 && v[3] == 7);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        const std::vector<Obj> source(3);
+        v.Reserve(SIZE * 2);
+        int old_num_moved = Obj::num_moved;
+        v.Insert(v.cbegin() + 2, source.begin(), source.end());
+        assert(v.Size() == SIZE + 3);
+        assert(Obj::num_copied + Obj::num_assigned == 3);
+        // Хвост сдвигается один раз
+        assert(Obj::num_moved - old_num_moved + Obj::num_move_assigned == static_cast<int>(SIZE - 2));
+
+        old_num_moved = Obj::num_moved;
+        v.Insert(v.cbegin() + 1, SIZE, Obj{1});
+        assert(v.Size() == SIZE * 2 + 3);
+        assert(v.Capacity() == SIZE * 4);
+        // Одна реаллокация
+        assert(Obj::num_moved - old_num_moved == static_cast<int>(SIZE + 3));
+        assert(v[SIZE].id == 1 && v[SIZE + 1].id == 0);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        std::vector<Obj> source(3);
+        source[2].throw_on_copy = true;
+        try {
+            v.Append(source.begin(), source.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
         }
-        Dump();
-    } catch (...) {
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + 3));
     }
-    try {
-        const size_t NUM = 10;
-        C c;
+    {
+        Vector<TestObj> v(SIZE);
+        v.Insert(v.cbegin() + 1, SIZE * 3, v[SIZE - 1]);
+        assert(v.Size() == SIZE * 4);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+    {
+        Vector<uint64_t, MallocAllocator<uint64_t>> v{1, 2};
+        const uint64_t source[] = {3, 4, 5};
+        v.Insert(v.cbegin() + 1, std::begin(source), std::end(source));
+        v.Insert(v.cbegin(), 2, v[4]);
+        assert((std::vector<uint64_t>(v.begin(), v.end()) == std::vector<uint64_t>{2, 2, 1, 3, 4, 5, 2}));
+    }
+}
+
+void Test13() {
+    const size_t SIZE = 10;
+    {
+        Vector<int> v{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        auto pos = v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(pos == v.begin() + 2 && *pos == 5);
+        assert(v.Size() == 7 && v.Capacity() == SIZE);
+        assert(v.Erase(v.cbegin(), v.cbegin()) == v.begin());
+        assert(v.EraseIf([](int x) {
+                   return x % 2 == 1;
+               })
+               == 4);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{0, 6, 8}));
+        v.PushBack(6);
+        assert(v.Remove(v[1]) == 2);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{0, 8}));
+        assert(v.Remove(42) == 0);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        v.Erase(v.cbegin() + 1, v.cbegin() + 3);
+        assert(v.Size() == SIZE - 2);
+        assert(v[1].id == 3);
+        assert(Obj::num_move_assigned == static_cast<int>(SIZE - 3));
+        assert(Obj::num_destroyed == 2);
+
+        Obj::num_move_assigned = 0;
+        const size_t removed = v.EraseIf([](const Obj& obj) {
+            return obj.id % 3 == 0;
+        });
+        // Удалены 0, 3, 6, 9, остались 4, 5, 7, 8
+        assert(removed == 4);
+        assert(v.Size() == SIZE - 6);
+        assert(v[0].id == 4 && v[1].id == 5 && v[2].id == 7 && v[3].id == 8);
+        assert(Obj::num_move_assigned == 4);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE - 6));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test14() {
+    const size_t SIZE = 1000;
+    {
+        Vector<char> v(SIZE, DEFAULT_INIT);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        std::fill(v.begin(), v.end(), 'x');
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(v.Size() == SIZE * 2);
+        assert(std::all_of(v.begin(), v.begin() + SIZE, [](char c) {
+            return c == 'x';
+        }));
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE * 2);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, DEFAULT_INIT);
+        v.ResizeDefaultInit(SIZE + 1);
+        assert(Obj::num_default_constructed == SIZE + 1);
+        v.ResizeDefaultInit(1);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    Obj::ResetCounters();
+    {
+        Obj::default_construction_throw_countdown = SIZE / 2;
+        try {
+            Vector<Obj> v(SIZE, DEFAULT_INIT);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v[SIZE / 2 - 1].id = 1;
+        v.Resize(SIZE / 2);
+        v.ShrinkToFit();
+        assert(v.Size() == SIZE / 2 && v.Capacity() == SIZE / 2);
+        assert(v[SIZE / 2 - 1].id == 1);
+        assert(Obj::num_moved == SIZE / 2);
+        assert(Obj::num_copied == 0);
+        v.ShrinkToFit();
+        assert(Obj::num_moved == SIZE / 2);
+
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+
+        v.Resize(SIZE);
+        v.ReleaseMemory();
+        assert(v.Size() == 0 && v.Capacity() == 0);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Vector<uint64_t, MallocAllocator<uint64_t>> v(SIZE);
+        v[0] = 42;
+        v.Resize(1);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 1 && v[0] == 42);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        v[SIZE - 1].throw_on_copy = true;
+        // Элементы перемещаются, так как конструктор перемещения Obj не бросает исключений
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE && v.Size() == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+    }
+}
+
+#ifdef ADVANCED_VECTOR_STATS
+void Test16() {
+    const size_t SIZE = 100;
+    static VectorStats last_stats;
+    SetVectorStatsHandler([](const VectorStats& stats) {
+        if (stats.label != nullptr) {
+            last_stats = stats;
+        }
+    });
+    {
+        Vector<Obj> v;
+        v.SetStatsLabel("Test16");
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        // Вместимость растёт как 1, 2, 4, ..., 128
+        assert(v.Stats().allocations == 8);
+        assert(v.Stats().reallocations == 7);
+        assert(v.Stats().elements_moved == 127);
+        assert(v.Stats().elements_copied == 0);
+        assert(v.Stats().bytes_allocated == 255 * sizeof(Obj));
+        assert(v.Stats().peak_capacity == 128);
+
+        v.Resize(1);
+        v.ShrinkToFit();
+        assert(v.Stats().reallocations == 8);
+        assert(v.Stats().peak_capacity == 128);
+
+        Vector<Obj> moved(std::move(v));
+        assert(moved.Stats().reallocations == 8);
+    }
+    assert(last_stats.label == std::string("Test16"));
+    assert(last_stats.reallocations == 8);
+    {
+        Vector<int> v(SIZE);
+        v.Reserve(SIZE * 2);
+        assert(v.Stats().allocations == 2);
+        assert(v.Stats().elements_relocated == SIZE);
+    }
+    {
+        // Присваивание с неравными аллокаторами учитывает одно перераспределение только у получателя
+        static size_t total_allocations = 0;
+        SetVectorStatsHandler([](const VectorStats& stats) {
+            total_allocations += stats.allocations;
+        });
+        using Alloc = CountingAllocator<int>;
+        {
+            Vector<int, Alloc> source(SIZE, Alloc{1});
+            Vector<int, Alloc> assigned(SIZE / 2, Alloc{2});
+            assigned = std::move(source);
+            assert(assigned.Stats().allocations == 2 && assigned.Stats().reallocations == 1);
+            assigned = Vector<int, Alloc>(SIZE * 2, Alloc{1});
+            assert(assigned.Stats().allocations == 3 && assigned.Stats().reallocations == 2);
+            const Vector<int, Alloc> larger(SIZE * 4, Alloc{2});
+            assigned = larger;
+            assert(assigned.Stats().allocations == 4 && assigned.Stats().reallocations == 3);
+        }
+        assert(total_allocations == 7);
+
+        // Assign с ростом тоже учитывает одно перераспределение
+        total_allocations = 0;
         {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+            Vector<int> v(SIZE);
+            v.Assign(SIZE * 2, 1);
+            assert(v.Stats().allocations == 2 && v.Stats().reallocations == 1);
         }
-        Dump();
-    } catch (...) {
+        assert(total_allocations == 2);
+    }
+    SetVectorStatsHandler(nullptr);
+}
+#endif
+
+void Test17() {
+    const size_t SIZE = 100;
+    using Alloc = CountingAllocator<Obj>;
+    Obj::ResetCounters();
+    {
+        Vector<Obj, Alloc> v(SIZE, Alloc{1});
+        const Obj* data = &v[0];
+        AllocationCounters::Reset();
+
+        // Перемещение только забирает буфер: без выделений памяти и операций с элементами
+        Vector<Obj, Alloc> moved(std::move(v));
+        assert(AllocationCounters::num_allocations == 0);
+        assert(AllocationCounters::num_deallocations == 0);
+        assert(&moved[0] == data);
+        assert(moved.Size() == SIZE && v.Size() == 0 && v.Capacity() == 0);
+
+        Vector<Obj, Alloc> assigned(SIZE / 2, Alloc{1});
+        AllocationCounters::Reset();
+        assigned = std::move(moved);
+        assert(AllocationCounters::num_allocations == 0);
+        assert(AllocationCounters::num_deallocations == 1);
+        assert(&assigned[0] == data);
+        assert(moved.Size() == 0 && moved.Capacity() == 0);
+
+        Vector<Obj, Alloc> empty;
+        AllocationCounters::Reset();
+        Vector<Obj, Alloc> moved_empty(std::move(empty));
+        moved_empty = std::move(empty);
+        assert(AllocationCounters::num_allocations == 0);
+
+        assert(Obj::num_moved == 0);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_move_assigned == 0);
+        assert(Obj::num_assigned == 0);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test18() {
+    const size_t MEDIUM_SIZE = 100;
+    const size_t LARGE_SIZE = 250;
+    {
+        // Присваивание большего вектора с переиспользованием вместимости
+        Obj::ResetCounters();
+        Vector<Obj> v(MEDIUM_SIZE / 2);
+        v.Reserve(LARGE_SIZE);
+        Vector<Obj> rhs(MEDIUM_SIZE);
+        for (size_t i = 0; i < MEDIUM_SIZE; ++i) {
+            rhs[i].id = static_cast<int>(i);
+        }
+        v = rhs;
+        assert(v.Size() == MEDIUM_SIZE && v.Capacity() == LARGE_SIZE);
+        for (size_t i = 0; i < MEDIUM_SIZE; ++i) {
+            assert(v[i].id == static_cast<int>(i));
+        }
+        assert(Obj::num_assigned == MEDIUM_SIZE / 2);
+        assert(Obj::num_copied == MEDIUM_SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == MEDIUM_SIZE * 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        struct Snapshot {
+            uint64_t key;
+            double values[3];
+        };
+        Vector<Snapshot> v(MEDIUM_SIZE);
+        Vector<Snapshot> rhs(LARGE_SIZE);
+        for (size_t i = 0; i < LARGE_SIZE; ++i) {
+            rhs[i] = {i, {1.0, 2.0, static_cast<double>(i)}};
+        }
+        v.Reserve(LARGE_SIZE);
+        v = rhs;
+        assert(v.Size() == LARGE_SIZE && v.Capacity() == LARGE_SIZE);
+        assert(v[LARGE_SIZE - 1].key == LARGE_SIZE - 1 && v[MEDIUM_SIZE].values[2] == MEDIUM_SIZE);
+
+        rhs.Resize(MEDIUM_SIZE / 2);
+        v = rhs;
+        assert(v.Size() == MEDIUM_SIZE / 2 && v.Capacity() == LARGE_SIZE);
+        assert(v[MEDIUM_SIZE / 2 - 1].key == MEDIUM_SIZE / 2 - 1);
+
+        const Vector<Snapshot> copy(v);
+        assert(copy.Size() == MEDIUM_SIZE / 2 && copy[1].key == 1);
+    }
+}
+
+void Test19() {
+    const size_t SIZE = 1003;
+    {
+        Vector<int> v(SIZE);
+        Fill(v, 7);
+        assert(std::all_of(v.begin(), v.end(), [](int x) {
+            return x == 7;
+        }));
+        assert(Count(v, 7) == SIZE);
+        assert(Find(v, 8) == v.end());
+        std::iota(v.begin(), v.end(), -500);
+        assert(Find(v, 0) == v.begin() + 500);
+        assert(Find(v, 502) == v.begin() + SIZE - 1);
+        assert(Count(v, 3) == 1);
+        assert(Sum(v) == std::accumulate(v.begin(), v.end(), int64_t{0}));
+        assert((MinMax(v) == std::pair{-500, 502}));
+        v[SIZE / 3] = -1000;
+        assert(MinMax(v).first == -1000);
+    }
+    {
+        Vector<uint8_t> v(SIZE);
+        Fill(v, uint8_t{255});
+        // Сумма не переполняется малым типом элемента
+        assert(Sum(v) == 255 * SIZE);
+    }
+    {
+        Vector<double> v;
+        v.Assign(SIZE, 0.5);
+        assert(v.Size() == SIZE && Sum(v) == 0.5 * SIZE);
+        v[SIZE - 2] = -2.5;
+        assert((MinMax(v) == std::pair{-2.5, 0.5}));
+        assert(Find(v, -2.5) == v.begin() + SIZE - 2);
+        const auto& cv = v;
+        assert(Find(cv, 1.0) == cv.end());
+    }
+    {
+        Vector<int> v{1, 2, 3};
+        v.Assign(2, v[2]);
+        assert(v.Size() == 2 && v[0] == 3 && v[1] == 3);
+        v.Assign(10, v[0]);
+        assert(v.Size() == 10 && Count(v, 3) == 10);
+        v.Resize(25, v[9]);
+        assert(v.Size() == 25 && Count(v, 3) == 25);
+        v.Resize(5, 4);
+        assert(v.Size() == 5);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(3);
+        v.Resize(5, Obj{1});
+        assert(v[4].id == 1 && v[2].id == 0);
+        v.Assign(2, Obj{2});
+        assert(v.Size() == 2 && v[1].id == 2);
+        assert(Obj::GetAliveObjectCount() == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test20() {
+    const size_t SIZE = 100;
+    auto is_aligned = [](const void* p, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+    };
+    {
+        Vector<float, AlignedAllocator<float>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(is_aligned(v.begin(), CACHE_LINE_SIZE));
+        }
+        v.ShrinkToFit();
+        assert(is_aligned(v.begin(), CACHE_LINE_SIZE));
+        Vector<float, AlignedAllocator<float>> copy(v);
+        assert(is_aligned(copy.begin(), CACHE_LINE_SIZE) && copy[SIZE - 1] == v[SIZE - 1]);
+    }
+    {
+        Vector<double, AlignedAllocator<double, 4096>> v(SIZE);
+        assert(is_aligned(v.begin(), 4096));
+    }
+    {
+        // Выравнивание сверхвыровненных типов соблюдает и std::allocator
+        struct alignas(128) Wide {
+            char data[3];
+        };
+        Vector<Wide> v(3);
+        v.Reserve(10);
+        assert(is_aligned(v.begin(), alignof(Wide)));
+    }
+    {
+        Vector<int, AlignedAllocator<int>, CacheLinePaddedGrowth<>> v;
+        v.PushBack(1);
+        assert(v.Capacity() == CACHE_LINE_SIZE / sizeof(int));
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+            assert(v.Capacity() * sizeof(int) % CACHE_LINE_SIZE == 0);
+        }
+        struct Triple {
+            char data[3];
+        };
+        // Кеш-линия не делится на размер элемента: вместимость округляется вниз внутри последней линии
+        assert((CacheLinePaddedGrowth<>::NextCapacity(0, sizeof(Triple)) == CACHE_LINE_SIZE / sizeof(Triple)));
+        assert((CacheLinePaddedGrowth<>::NextCapacity(21, sizeof(Triple)) == 2 * CACHE_LINE_SIZE / sizeof(Triple)));
+    }
+}
+
+void Test21() {
+    const size_t THRESHOLD = size_t{1} << 20;
+    const size_t SIZE = THRESHOLD / sizeof(int) * 3;
+    {
+        using Alloc = HugePageAllocator<int, THRESHOLD>;
+        Vector<int, Alloc> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+            // Блоки от порога отображаются и выровнены по большой странице
+            if (Alloc::IsMapped(v.Capacity())) {
+                assert(reinterpret_cast<uintptr_t>(v.begin()) % HUGE_PAGE_SIZE == 0);
+            }
+        }
+        assert(v[SIZE - 1] == static_cast<int>(SIZE - 1) && v[SIZE / 2] == static_cast<int>(SIZE / 2));
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(!Alloc::IsMapped(v.Capacity()) && v[9] == 9);
+    }
+    {
+        using Alloc = HugePageAllocator<uint64_t, THRESHOLD, HUGE_PAGES_EXPLICIT | HUGE_PAGES_POPULATE>;
+        Vector<uint64_t, Alloc> v(SIZE);
+        assert(std::all_of(v.begin(), v.end(), [](uint64_t x) {
+            return x == 0;
+        }));
+        Fill(v, uint64_t{3});
+        Vector<uint64_t, Alloc> copy(v);
+        assert(Sum(copy) == 3 * SIZE);
+    }
+}
+
+void Test22() {
+    const size_t SIZE = 100000;
+    using Alloc = NumaAllocator<int>;
+    {
+        Vector<int, Alloc> v(SIZE, Alloc(NumaPolicy::Bind(0)));
+        assert(v.GetAllocator().GetPolicy() == NumaPolicy::Bind(0));
+        // Узел 0 есть в любой системе, поэтому привязка к нему всегда выполнима
+        const int node = NumaNodeOf(&v[SIZE / 2]);
+        assert(node == 0 || node == -1);
+        const std::vector<size_t> pages = NumaPagesPerNode(v.begin(), SIZE * sizeof(int));
+        assert(pages.empty() || pages[0] * numa_detail::PageSize() >= SIZE * sizeof(int));
+
+        // Политика переходит вместе с буфером
+        Vector<int, Alloc> other;
+        other = std::move(v);
+        assert(other.GetAllocator().GetPolicy() == NumaPolicy::Bind(0));
+        v = other;
+        assert(v.GetAllocator().GetPolicy() == NumaPolicy::Bind(0) && v[SIZE - 1] == 0);
+
+        // Буфер, размещённый по другой политике, не переиспользуется
+        assert(Alloc(NumaPolicy::Bind(0)) != Alloc(NumaPolicy::Interleave(1)));
+        Vector<int, Alloc> interleaved(SIZE * 2, Alloc(NumaPolicy::Interleave(1)));
+        const int* old_data = interleaved.begin();
+        interleaved = other;
+        assert(interleaved.GetAllocator() == other.GetAllocator() && interleaved.begin() != old_data);
+        assert(interleaved.Size() == SIZE && interleaved[SIZE - 1] == 0);
+    }
+    {
+        Vector<int, Alloc> v(Alloc(NumaPolicy::FirstTouch(4)));
+        v.Resize(SIZE, 5);
+        assert(Count(v, 5) == SIZE);
+        v.Reserve(SIZE * 3);
+        assert(v.GetAllocator().GetPolicy().first_touch_threads == 4 && v[SIZE - 1] == 5);
+    }
+    {
+        Vector<double, NumaAllocator<double>> v(SIZE, NumaAllocator<double>(NumaPolicy::Interleave(1)));
+        v[0] = 1.5;
+        assert(Sum(v) == 1.5);
+    }
+    {
+        // Узла 63 нет, поэтому ядро отклоняет привязку: отказ учитывается, а строгая политика выбрасывает исключение
+        const size_t failures = NumaPolicyFailures();
+        Vector<int, Alloc> v(SIZE, Alloc(NumaPolicy::Bind(63)));
+        assert(NumaPolicyFailures() == failures + 1 && v[SIZE - 1] == 0);
+        try {
+            Vector<int, Alloc> strict(SIZE, Alloc(NumaPolicy::Bind(63).Strict()));
+            assert(false);
+        } catch (const std::system_error&) {
+        }
+        assert(NumaPolicyFailures() == failures + 2);
+
+        // Узел вне маски не вызывает сдвиг за пределы разрядов и тоже считается отказом
+        assert(NumaPolicy::Bind(64).nodes == 0 && NumaPolicy::Bind(1000).nodes == 0);
+        assert(NumaPolicy::Bind(63).nodes == uint64_t{1} << 63);
+        Vector<int, Alloc> out_of_mask(SIZE, Alloc(NumaPolicy::Bind(64)));
+        assert(NumaPolicyFailures() == failures + 3 && out_of_mask[0] == 0);
+    }
+    // Пустой диапазон не содержит страниц
+    assert(NumaPagesPerNode(nullptr, 0).empty());
+}
+
+void Test23() {
+    struct Record {
+        uint64_t id;
+        double value;
+        char tag[8];
+    };
+    const size_t SIZE = 10000;
+    const std::string path = "/tmp/advanced_vector_test_" + std::to_string(getpid()) + ".bin";
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == 0);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(Record{i, i * 0.5, "record"});
+        }
+        v.EmplaceBack(v[0]);
+        assert(v.Size() == SIZE + 1 && v[SIZE].id == 0);
+        v.PopBack();
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE);
+        v.Flush();
+    }
+    {
+        // Повторное открытие видит сохранённые элементы
+        MappedVector<Record> v(path);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(v[SIZE - 1].id == SIZE - 1 && v[SIZE / 2].value == SIZE / 4.0);
+        assert(std::string(v[7].tag) == "record");
+        v.Resize(SIZE / 2);
+        v.Resize(SIZE / 2 + 1);
+        assert(v[SIZE / 2].id == 0);
+
+        MappedVector<Record> moved(std::move(v));
+        assert(moved.Size() == SIZE / 2 + 1 && v.Size() == 0);
+    }
+    {
+        MappedVector<Record> v(path);
+        assert(v.Size() == SIZE / 2 + 1);
+        v.Clear();
+    }
+    {
+        // Вместимость в повреждённом заголовке, произведение которой на sizeof(T) переполняется
+        const uint64_t capacity = std::numeric_limits<uint64_t>::max() / sizeof(Record) + 1;
+        const int fd = open(path.c_str(), O_RDWR);
+        assert(fd >= 0);
+        const ssize_t written = pwrite(fd, &capacity, sizeof(capacity), offsetof(MappedVectorHeader, capacity));
+        assert(written == sizeof(capacity));
+        (void)written;
+        close(fd);
+        bool corrupt_thrown = false;
+        try {
+            MappedVector<Record> corrupt(path);
+        } catch (const std::runtime_error&) {
+            corrupt_thrown = true;
+        }
+        assert(corrupt_thrown);
+    }
+    bool thrown = false;
+    try {
+        MappedVector<uint32_t> wrong_type(path);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    unlink(path.c_str());
+}
+
+void Test24() {
+    const size_t SIZE = 10000;
+    struct Point {
+        int x;
+        int y;
+    };
+    Vector<Point> points;
+    for (size_t i = 0; i < SIZE; ++i) {
+        points.PushBack(Point{static_cast<int>(i), -static_cast<int>(i)});
+    }
+    {
+        std::stringstream stream;
+        WriteTo(points, stream);
+        Vector<Point> loaded{Point{1, 1}};
+        ReadFrom(loaded, stream);
+        assert(loaded.Size() == SIZE && loaded.Capacity() == SIZE);
+        assert(loaded[SIZE - 1].x == static_cast<int>(SIZE - 1) && loaded[7].y == -7);
+    }
+    {
+        const std::string path = "/tmp/advanced_vector_io_" + std::to_string(getpid()) + ".bin";
+        const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        WriteTo(points, fd);
+        WriteTo(Vector<Point>{}, fd);
+
+        lseek(fd, 0, SEEK_SET);
+        Vector<Point> loaded;
+        ReadFrom(loaded, fd);
+        assert(loaded.Size() == SIZE && loaded[SIZE / 2].x == static_cast<int>(SIZE / 2));
+        ReadFrom(loaded, fd);
+        assert(loaded.Size() == 0);
+
+        // Чтение частями резервирует память один раз и дописывает элементы в конец
+        lseek(fd, 0, SEEK_SET);
+        VectorStreamReader<int> reader(fd);
+        Vector<Point> chunks;
+        size_t chunk_count = 0;
+        while (reader.ReadNext(chunks, 3000) != 0) {
+            ++chunk_count;
+            assert(chunks.Capacity() == SIZE);
+        }
+        assert(chunk_count == 4 && chunks.Size() == SIZE && chunks[SIZE - 1].y == -static_cast<int>(SIZE - 1));
+        close(fd);
+        unlink(path.c_str());
+    }
+    {
+        std::stringstream stream;
+        WriteTo(points, stream);
+        std::string truncated = stream.str();
+        truncated.resize(truncated.size() - 1);
+        std::istringstream in(truncated);
+        Vector<Point> loaded;
+        bool thrown = false;
+        try {
+            ReadFrom(loaded, in);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && loaded.Size() == 0);
+
+        std::stringstream other;
+        WriteTo(Vector<char>(3), other);
+        thrown = false;
+        try {
+            VectorStreamReader<std::istream&>(other).ReadNext(loaded, 1);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    {
+        // Повреждённый заголовок не приводит к выделению памяти под несуществующие данные
+        auto corrupt = [](uint64_t size, uint64_t magic = VectorIoHeader::MAGIC) {
+            VectorIoHeader header;
+            header.magic = magic;
+            header.element_size = sizeof(Point);
+            header.size = size;
+            std::string data(reinterpret_cast<const char*>(&header), sizeof(header));
+            data.append(4 * sizeof(Point), '\0');
+            return data;
+        };
+        auto read_fails = [](const std::string& data, Vector<Point>& loaded) {
+            std::istringstream in(data);
+            try {
+                ReadFrom(loaded, in);
+            } catch (const std::runtime_error&) {
+                return true;
+            } catch (const std::length_error&) {
+                return true;
+            }
+            return false;
+        };
+        Vector<Point> loaded;
+        assert(read_fails(corrupt(4, 0), loaded) && loaded.Size() == 0);
+        assert(read_fails(corrupt(std::numeric_limits<uint64_t>::max()), loaded) && loaded.Capacity() == 0);
+        // Размер потока неизвестен, поэтому память выделяется только под очередную порцию
+        assert(read_fails(corrupt(uint64_t{1} << 40), loaded) && loaded.Size() == 0);
+        assert(loaded.Capacity() * sizeof(Point) <= vector_io_detail::READ_CHUNK_BYTES);
+
+        // Размер из заголовка проверяется по длине файла до выделения памяти
+        const std::string path = "/tmp/advanced_vector_io_corrupt_" + std::to_string(getpid()) + ".bin";
+        const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        assert(fd >= 0);
+        const std::string data = corrupt(SIZE);
+        assert(write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size()));
+        lseek(fd, 0, SEEK_SET);
+        Vector<Point> from_file;
+        try {
+            ReadFrom(from_file, fd);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(from_file.Size() == 0 && from_file.Capacity() == 0);
+        lseek(fd, 0, SEEK_SET);
+        try {
+            VectorStreamReader<int>(fd).ReadNext(from_file, 1);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(from_file.Capacity() == 0);
+        close(fd);
+        unlink(path.c_str());
+    }
+}
+
+// Тип с потокобезопасным подсчётом живых объектов для параллельных тестов
+struct AtomicObj {
+    AtomicObj() {
+        if (construction_throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+    }
+    AtomicObj(const AtomicObj& other)
+        : id(other.id)  //
+    {
+        if (construction_throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+    }
+    AtomicObj& operator=(const AtomicObj& other) = default;
+    ~AtomicObj() {
+        --alive;
+    }
+
+    int id = 0;
+
+    static inline std::atomic<int> alive = 0;
+    // Конструирование с этим порядковым номером выбрасывает исключение, не больше 0 — никогда
+    static inline std::atomic<int> construction_throw_countdown = 0;
+};
+
+void Test25() {
+    const size_t SIZE = 100000;
+    const ParallelTag policy{4, 1000};
+    {
+        Vector<AtomicObj> v(SIZE, policy);
+        assert(v.Size() == SIZE && AtomicObj::alive == static_cast<int>(SIZE));
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        Vector<AtomicObj> copy(v, policy);
+        assert(copy.Size() == SIZE && copy[SIZE - 1].id == static_cast<int>(SIZE - 1));
+        assert(AtomicObj::alive == static_cast<int>(2 * SIZE));
+
+        copy.Resize(SIZE / 3, policy);
+        assert(AtomicObj::alive == static_cast<int>(SIZE + SIZE / 3));
+        copy.Resize(SIZE * 2, policy);
+        assert(copy[SIZE / 3 - 1].id == static_cast<int>(SIZE / 3 - 1) && copy[SIZE * 2 - 1].id == 0);
+        copy.Clear(policy);
+        assert(copy.Size() == 0 && AtomicObj::alive == static_cast<int>(SIZE));
+
+        // Исключение в одной из частей откатывает все части
+        AtomicObj::construction_throw_countdown = static_cast<int>(SIZE / 2);
+        bool thrown = false;
+        try {
+            Vector<AtomicObj> failed(SIZE, policy);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && AtomicObj::alive == static_cast<int>(SIZE));
+
+        AtomicObj::construction_throw_countdown = static_cast<int>(SIZE - 1);
+        thrown = false;
+        try {
+            Vector<AtomicObj> failed(v, policy);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && AtomicObj::alive == static_cast<int>(SIZE));
+
+        // Перенос в новый буфер копирует SIZE элементов, исключение возникает при создании новых
+        AtomicObj::construction_throw_countdown = static_cast<int>(SIZE + SIZE / 2);
+        thrown = false;
+        try {
+            v.Resize(SIZE * 2, policy);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown && v.Size() == SIZE && v.Capacity() == SIZE * 2 && AtomicObj::alive == static_cast<int>(SIZE));
+        AtomicObj::construction_throw_countdown = 0;
+    }
+    assert(AtomicObj::alive == 0);
+    {
+        // Малые векторы и тривиальные типы
+        Vector<int> v(10, PARALLEL);
+        assert(Count(v, 0) == 10);
+        Vector<int> ints(SIZE, policy);
+        std::iota(ints.begin(), ints.end(), 0);
+        Vector<int> copy(ints, policy);
+        assert(std::equal(ints.begin(), ints.end(), copy.begin(), copy.end()));
+    }
+}
+
+void Test26() {
+    const size_t THREADS = 8;
+    const size_t PER_THREAD = 20000;
+    {
+        ConcurrentVector<std::string> v;
+        std::vector<std::thread> threads;
+        std::atomic<size_t> checked = 0;
+        for (size_t t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&v, &checked, t] {
+                for (size_t i = 0; i < PER_THREAD; ++i) {
+                    const size_t index = v.EmplaceBack(std::to_string(t * PER_THREAD + i));
+                    const std::string* address = &v[index];
+                    // Чтение элементов, добавленных другими потоками
+                    const size_t other = index / 2;
+                    if (v.IsReady(other) && !v[other].empty()) {
+                        ++checked;
+                    }
+                    assert(&v[index] == address && *address == std::to_string(t * PER_THREAD + i));
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        assert(v.Size() == THREADS * PER_THREAD && checked > 0);
+        std::vector<bool> seen(THREADS * PER_THREAD);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v.IsReady(i));
+            const size_t value = std::stoul(v[i]);
+            assert(!seen[value]);
+            seen[value] = true;
+        }
+    }
+    {
+        ConcurrentVector<AtomicObj> v;
+        v.EmplaceBack();
+        AtomicObj::construction_throw_countdown = 1;
+        bool thrown = false;
+        try {
+            v.EmplaceBack();
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        // Индекс неудачно созданного элемента остаётся пропуском
+        assert(thrown && v.Size() == 2 && v.IsReady(0) && !v.IsReady(1) && !v.IsReady(2));
+        v.PushBack(v[0]);
+        assert(v.IsReady(2) && AtomicObj::alive == 2);
+    }
+    assert(AtomicObj::alive == 0);
+}
+
+void Test27() {
+    const size_t SIZE = 1000;
+    Obj::ResetCounters();
+    {
+        SegmentedVector<Obj, 16> v;
+        Vector<const Obj*> addresses;
+        for (size_t i = 0; i < SIZE; ++i) {
+            addresses.PushBack(&v.EmplaceBack(static_cast<int>(i)));
+        }
+        // Рост не переносит элементы
+        assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+        assert(v.Size() == SIZE && v.Capacity() == (SIZE + 15) / 16 * 16);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(&v[i] == addresses[i] && v[i].id == static_cast<int>(i));
+        }
+        v.PushBack(v[0]);
+        assert(v[SIZE].id == 0);
+
+        // Итераторы произвольного доступа
+        auto it = std::find_if(v.begin(), v.end(), [](const Obj& obj) {
+            return obj.id == 500;
+        });
+        assert(it - v.begin() == 500 && (it + 20)->id == 520 && it[-100].id == 400);
+        SegmentedVector<Obj, 16>::const_iterator cit = it;
+        assert(cit == it && cit < v.cend() && v.cend() - cit == static_cast<std::ptrdiff_t>(SIZE + 1 - 500));
+        std::reverse(v.begin(), v.end());
+        assert(v[0].id == 0 && v[1].id == static_cast<int>(SIZE - 1));
+        std::sort(v.begin(), v.end(), [](const Obj& lhs, const Obj& rhs) {
+            return lhs.id < rhs.id;
+        });
+        assert(v[SIZE].id == static_cast<int>(SIZE - 1) && v[1].id == 0);
+
+        SegmentedVector<Obj, 16> copy(v);
+        assert(copy.Size() == v.Size() && copy[SIZE / 2].id == v[SIZE / 2].id);
+        copy.Resize(10);
+        copy.ShrinkToFit();
+        assert(copy.Capacity() == 16);
+        copy = v;
+        assert(copy.Size() == SIZE + 1);
+        SegmentedVector<Obj, 16> moved(std::move(copy));
+        assert(moved.Size() == SIZE + 1 && copy.Size() == 0);
+        copy = std::move(moved);
+        assert(copy.Size() == SIZE + 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Исключение при копировании не оставляет созданных элементов
+        SegmentedVector<Obj, 8> v(20);
+        Obj::ResetCounters();
+        Obj::default_construction_throw_countdown = 5;
+        try {
+            v.Resize(40);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 20 && Obj::GetAliveObjectCount() == 0);
+        v[10].throw_on_copy = true;
+        try {
+            SegmentedVector<Obj, 8> copy(v);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        SegmentedVector<int> v;
+        static_assert(SegmentedVector<int>::BLOCK_SIZE == SEGMENT_BYTES / sizeof(int));
+        v.Resize(SIZE * 10);
+        assert(std::count(v.begin(), v.end(), 0) == static_cast<std::ptrdiff_t>(SIZE * 10));
+    }
+    {
+        // Аллокатор распространяется при присваивании и обмене только вместе с признаками распространения
+        using Alloc = CountingAllocator<int>;
+        SegmentedVector<int, 8, Alloc> source(20, Alloc{1});
+        source[19] = 7;
+        SegmentedVector<int, 8, Alloc> target(Alloc{2});
+        target = source;
+        assert(target.GetAllocator().id == 2 && target.Size() == 20 && target[19] == 7);
+        target = std::move(source);
+        assert(target.GetAllocator().id == 2 && target.Size() == 20 && source.Size() == 0);
+
+        using PropagatingAlloc = CountingAllocator<int, true>;
+        SegmentedVector<int, 8, PropagatingAlloc> propagating_source(20, PropagatingAlloc{1});
+        SegmentedVector<int, 8, PropagatingAlloc> propagating(PropagatingAlloc{2});
+        propagating = propagating_source;
+        assert(propagating.GetAllocator().id == 1 && propagating.Size() == 20);
+        SegmentedVector<int, 8, PropagatingAlloc> other(PropagatingAlloc{3});
+        other.Swap(propagating);
+        assert(other.GetAllocator().id == 1 && propagating.GetAllocator().id == 3 && other.Size() == 20);
+        propagating = std::move(other);
+        assert(propagating.GetAllocator().id == 1 && propagating.Size() == 20);
+    }
+}
+
+void Test28() {
+    const size_t SIZE = 1000;
+    {
+        SoAVector<float, float, int> particles;
+        for (size_t i = 0; i < SIZE; ++i) {
+            particles.EmplaceBack(static_cast<float>(i), 0.5f, static_cast<int>(i % 3));
+        }
+        particles.PushBack({1.0f, 2.0f, 3});
+        particles.PushBack(std::tuple{2.0f, 3.0f, 4});
+        assert(particles.Size() == SIZE + 2);
+
+        // Столбец — непрерывный массив
+        Span<float> x = particles.Column<0>();
+        assert(x.Size() == SIZE + 2 && &x[1] == &x[0] + 1);
+        for (float& value : particles.Column<1>()) {
+            value *= 2;
+        }
+        assert(std::get<1>(particles[10]) == 1.0f && std::get<1>(particles[SIZE]) == 4.0f);
+
+        // Итератор обходит записи целиком
+        int sum = 0;
+        for (auto [px, py, kind] : particles) {
+            static_cast<void>(px);
+            static_cast<void>(py);
+            sum += kind;
+        }
+        assert(sum == 999 + 3 + 4);
+        auto it = std::find_if(particles.cbegin(), particles.cend(), [](auto row) {
+            return std::get<0>(row) == 500.0f;
+        });
+        assert(it - particles.cbegin() == 500 && std::get<2>(it[1]) == 501 % 3);
+
+        std::get<2>(particles[0]) = 42;
+        const SoAVector<float, float, int> copy(particles);
+        assert(copy.Size() == particles.Size() && std::get<2>(copy[0]) == 42);
+        particles.PushBack(particles[0]);
+        assert(std::get<2>(particles[SIZE + 2]) == 42);
+        particles.Resize(10);
+        particles.PopBack();
+        assert(particles.Size() == 9 && std::get<0>(particles[8]) == 8.0f);
+    }
+    {
+        // AtomicObj не имеет перемещающего конструктора, поэтому его столбец при росте копируется.
+        // Отказ копирования не меняет вектор, в том числе уже перенесённые столбцы
+        SoAVector<int, AtomicObj, std::string> v;
+        v.Reserve(4);
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i, AtomicObj(), std::string(32, 'a'));
+            std::get<1>(v[i]).id = i;
+        }
+        const std::string* name = &std::get<2>(v[0]);
+        AtomicObj::construction_throw_countdown = 3;
+        try {
+            v.Reserve(8);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Capacity() == 4 && &std::get<2>(v[0]) == name && std::get<2>(v[3]).size() == 32);
+        assert(AtomicObj::alive == 4);
+
+        AtomicObj::construction_throw_countdown = 5;
+        try {
+            v.EmplaceBack(5, std::get<1>(v[2]), "b");
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4 && AtomicObj::alive == 4);
+        AtomicObj::construction_throw_countdown = 0;
+        v.EmplaceBack(5, std::get<1>(v[2]), std::get<2>(v[0]));
+        assert(v.Size() == 5 && std::get<1>(v[4]).id == 2 && std::get<2>(v[4]).size() == 32);
+        SoAVector<int, AtomicObj, std::string> moved(std::move(v));
+        v = moved;
+        assert(AtomicObj::alive == 10 && v.Column<1>()[4].id == 2 && v.Column<0>()[4] == 5);
+    }
+    assert(AtomicObj::alive == 0);
+    {
+        // Стратегия роста задаётся первым параметром BasicSoAVector
+        BasicSoAVector<MinCapacityGrowth<16>, int, double> v;
+        v.EmplaceBack(1, 1.0);
+        assert(v.Capacity() == 16);
+        v.EmplaceBack(2, 2.0);
+        auto first = v.begin();
+        auto last = v.end();
+        assert(first < last && last > first && first <= first && last >= first && !(first >= last));
+    }
+}
+
+void Test29() {
+    const size_t SIZE = 1000;
+    {
+        BitVector bits;
+        std::vector<bool> expected;
+        for (size_t i = 0; i < SIZE; ++i) {
+            bits.PushBack(i % 3 == 0);
+            expected.push_back(i % 3 == 0);
+        }
+        assert(bits.Size() == SIZE && bits.WordCount() == (SIZE + 63) / 64);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(bits[i] == expected[i]);
+        }
+        assert(bits.Count() == (SIZE + 2) / 3);
+        assert(bits.FindFirst() == 0 && bits.FindNext(1) == 3 && bits.FindNext(SIZE - 2) == SIZE - 1 && bits.FindNext(SIZE) == SIZE);
+
+        // Ссылки-заместители
+        bits[1] = true;
+        bits[0] = bits[2];
+        bits[3].Flip();
+        assert(!bits[0] && bits[1] && !bits[3] && bits.FindFirst() == 1);
+
+        const size_t set = bits.Count();
+        assert(set == (SIZE + 2) / 3 - 1);
+        bits.Flip();
+        assert(bits.Count() == SIZE - set);
+        bits.Resize(SIZE + 100, true);
+        assert(bits.Count() == SIZE - set + 100 && bits[SIZE + 99]);
+        bits.Resize(10);
+        const size_t count = bits.Count();
+        bits.Resize(200);
+        assert(bits.Count() == count && bits.FindNext(10) == 200);
+        bits.PopBack();
+        assert(bits.Size() == 199);
+    }
+    {
+        BitVector a(SIZE, true);
+        BitVector b(SIZE);
+        assert(a.Count() == SIZE && b.Count() == 0 && b.FindFirst() == SIZE);
+        for (size_t i = 0; i < SIZE; i += 2) {
+            b[i] = true;
+        }
+        assert((a & b) == b && (a | b) == a && (a ^ b).Count() == SIZE / 2);
+        BitVector c = b;
+        c ^= a;
+        assert(c.FindFirst() == 1 && c != b);
+        c &= b;
+        assert(c.Count() == 0);
+        c = a;
+        assert(c == a);
+        BitVector moved(std::move(c));
+        assert(moved.Count() == SIZE && c.Size() == 0);
+        // Слово упаковывает 64 флага
+        assert(a.Words()[0] == ~uint64_t{0} && (a.Words()[SIZE / 64] >> (SIZE % 64)) == 0);
+    }
+}
+
+// Копирование освобождает другую копию CowVector, как это мог бы сделать другой поток
+struct ReleasingOnCopy {
+    explicit ReleasingOnCopy(int value)
+        : value(value)  //
+    {
+    }
+    ReleasingOnCopy(const ReleasingOnCopy& other) {
+        if (copy_countdown > 0 && --copy_countdown == 0) {
+            *victim = CowVector<ReleasingOnCopy>();
+        }
+        value = other.value;
+    }
+    ReleasingOnCopy& operator=(const ReleasingOnCopy&) = default;
+
+    int value = 0;
+
+    static inline CowVector<ReleasingOnCopy>* victim = nullptr;
+    static inline int copy_countdown = 0;
+};
+
+// CowVector
+void Test30() {
+    const size_t SIZE = 100;
+    {
+        CowVector<std::string> original;
+        for (size_t i = 0; i < SIZE; ++i) {
+            original.PushBack(std::to_string(i));
+        }
+        // Копия разделяет буфер, чтение его не копирует
+        CowVector<std::string> snapshot = original;
+        assert(original.IsShared() && snapshot.IsShared());
+        assert(&std::as_const(snapshot)[0] == &std::as_const(original)[0]);
+        size_t total = 0;
+        for (const std::string& s : std::as_const(snapshot)) {
+            total += s.size();
+        }
+        assert(total > SIZE && snapshot.IsShared());
+
+        // Первое изменение копирует буфер, снимок не меняется
+        original[0] = "changed";
+        assert(!original.IsShared() && !snapshot.IsShared());
+        assert(std::as_const(snapshot)[0] == "0" && std::as_const(original)[0] == "changed");
+
+        // Неразделённый буфер изменяется на месте
+        const std::string* data = &std::as_const(original)[0];
+        original.PushBack("last");
+        original.Erase(original.cbegin() + 1);
+        assert(original.Size() == SIZE && std::as_const(original)[1] == "2");
+        assert(original.Capacity() < 2 * SIZE || &std::as_const(original)[0] != data);
+        assert(snapshot.Size() == SIZE);
+
+        // Позиции, полученные из разделяемого буфера, применяются к собственной копии
+        CowVector<std::string> other = snapshot;
+        auto it = other.Insert(other.cbegin() + 1, "inserted");
+        assert(*it == "inserted" && other.Size() == SIZE + 1 && std::as_const(snapshot)[1] == "1");
+        other.Erase(other.cbegin(), other.cbegin() + 2);
+        assert(other.Size() == SIZE - 1 && std::as_const(other)[0] == "1");
+
+        CowVector<std::string> resized = snapshot;
+        resized.Resize(SIZE / 2);
+        resized.Resize(SIZE, "x");
+        assert(std::as_const(resized)[SIZE - 1] == "x" && snapshot.Size() == SIZE);
+        resized.EmplaceBack(std::as_const(resized)[0]);
+        assert(std::as_const(resized)[SIZE] == "0");
+
+        // Аргумент ссылается на прежний буфер, последнюю другую копию которого уничтожают во время вставки
+        Vector<ReleasingOnCopy> values;
+        values.Resize(SIZE, ReleasingOnCopy(7));
+        CowVector<ReleasingOnCopy> victim(std::move(values));
+        CowVector<ReleasingOnCopy> owner = victim;
+        ReleasingOnCopy::victim = &victim;
+        ReleasingOnCopy::copy_countdown = static_cast<int>(SIZE) + 1;
+        owner.EmplaceBack(std::as_const(owner)[0]);
+        assert(victim.Size() == 0 && owner.Size() == SIZE + 1 && std::as_const(owner)[SIZE].value == 7);
+
+        // Очистка разделяемого вектора не копирует элементы
+        CowVector<std::string> cleared = snapshot;
+        cleared.Clear();
+        assert(cleared.Size() == 0 && !snapshot.IsShared() && snapshot.Size() == SIZE);
+    }
+    {
+        // Снимки читаются из разных потоков, пока владелец продолжает изменять свою копию
+        CowVector<int> v{Vector<int>(SIZE)};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([snapshot = v] {
+                for (int round = 0; round < 100; ++round) {
+                    CowVector<int> copy = snapshot;
+                    int sum = std::accumulate(copy.cbegin(), copy.cend(), 0);
+                    assert(sum == 0);
+                    (void)sum;
+                }
+            });
+        }
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i] = 1;
+        }
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        assert(std::accumulate(v.cbegin(), v.cend(), 0) == static_cast<int>(SIZE));
+    }
+    {
+        Obj::ResetCounters();
+        {
+            CowVector<Obj> a(SIZE);
+            CowVector<Obj> b = a;
+            CowVector<Obj> c = std::move(b);
+            assert(Obj::num_copied == 0 && Obj::GetAliveObjectCount() == SIZE);
+            c.PopBack();
+            assert(Obj::num_copied == SIZE && Obj::GetAliveObjectCount() == 2 * SIZE - 1);
+            a = c;
+            assert(Obj::GetAliveObjectCount() == SIZE - 1);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+// EmplaceBackN и AppendGenerated
+void Test31() {
+    const size_t SIZE = 100;
+    {
+        Vector<int> v;
+        v.AppendGenerated(SIZE, [](size_t i) {
+            return static_cast<int>(i * i);
+        });
+        assert(v.Size() == SIZE && v[SIZE - 1] == static_cast<int>((SIZE - 1) * (SIZE - 1)));
+        // Одна реаллокация на пакет, при достаточной вместимости буфер не меняется
+        assert(v.Capacity() == SIZE);
+        v.Reserve(2 * SIZE);
+        const size_t capacity = v.Capacity();
+        v.EmplaceBackN(capacity - SIZE, 7);
+        assert(v.Capacity() == capacity && v[SIZE] == 7 && v[capacity - 1] == 7);
+        v.EmplaceBackN(0, 1);
+        assert(v.Size() == capacity);
+        // Аргумент может ссылаться на элемент вектора, который переносится в новый буфер
+        v.EmplaceBackN(SIZE, v[1]);
+        assert(v.Size() == capacity + SIZE && v.Capacity() >= capacity + SIZE && v[capacity + SIZE - 1] == 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.EmplaceBackN(SIZE, 1, std::string("one"));
+        assert(v.Size() == SIZE && v[SIZE - 1].name == "one" && Obj::num_constructed_with_id_and_name == static_cast<int>(SIZE));
+        v.AppendGenerated(SIZE, [](size_t i) {
+            return Obj(static_cast<int>(i));
+        });
+        assert(v.Size() == 2 * SIZE && v[2 * SIZE - 1].id == static_cast<int>(SIZE - 1));
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(2 * SIZE));
+    }
+    {
+        // Исключение удаляет только элементы пакета, вектор остаётся прежним
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        const Obj* data = v.begin();
+        Obj::default_construction_throw_countdown = static_cast<int>(SIZE / 2);
+        try {
+            v.EmplaceBackN(SIZE);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.begin() == data && Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+
+        v.Reserve(3 * SIZE);
+        try {
+            v.AppendGenerated(SIZE, [](size_t i) {
+                if (i == SIZE / 2) {
+                    throw std::runtime_error("Oops");
+                }
+                return Obj(static_cast<int>(i));
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+    }
+}
+
+// Вставка в середину без временного объекта
+void Test32() {
+    const size_t SIZE = 100;
+    {
+        Handle::num_moved = 0;
+        Vector<Handle> v;
+        v.Reserve(SIZE + 1);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        // Хвост сдвигается побайтово, элемент создаётся на месте вставки
+        auto it = v.Emplace(v.cbegin() + SIZE / 2, -1);
+        assert(Handle::num_moved == 0 && *it->ptr == -1 && it == v.begin() + SIZE / 2);
+        assert(*v[SIZE / 2 + 1].ptr == static_cast<int>(SIZE / 2) && *v[SIZE].ptr == static_cast<int>(SIZE - 1));
+    }
+    {
+        Vector<int> v;
+        v.Reserve(SIZE);
+        for (size_t i = 0; i < SIZE / 2; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        // Аргументы из сдвигаемой части вектора и перед ней
+        v.Insert(v.cbegin() + 1, v[3]);
+        assert(v[1] == 3 && v[4] == 3 && v.Size() == SIZE / 2 + 1);
+        v.Insert(v.cbegin() + 2, v[0]);
+        assert(v[2] == 0 && v[1] == 3 && v[3] == 1);
+        v.Insert(v.cbegin() + 1, std::move(v[v.Size() - 1]));
+        assert(v[1] == static_cast<int>(SIZE / 2 - 1) && v[v.Size() - 1] == static_cast<int>(SIZE / 2 - 1));
+        v.Emplace(v.cend(), v[1]);
+        assert(v[v.Size() - 1] == static_cast<int>(SIZE / 2 - 1) && v.Size() == SIZE / 2 + 4);
+    }
+    {
+        // Если конструктор выбросит исключение, хвост возвращается на место
+        struct Throwing {
+            explicit Throwing(int value)
+                : value(value)  //
+            {
+                if (value < 0) {
+                    throw std::runtime_error("Oops");
+                }
+            }
+            int value;
+        };
+        static_assert(IS_TRIVIALLY_RELOCATABLE<Throwing>);
+        Vector<Throwing> v;
+        v.Reserve(SIZE);
+        for (size_t i = 0; i < SIZE / 2; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        try {
+            v.Emplace(v.cbegin() + 1, -1);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE / 2);
+        for (size_t i = 0; i < SIZE / 2; ++i) {
+            assert(v[i].value == static_cast<int>(i));
+        }
+    }
+}
+
+// FlatSet и FlatMap
+void Test33() {
+    const int SIZE = 1000;
+    {
+        Vector<int> keys;
+        for (int i = 0; i < SIZE; ++i) {
+            keys.PushBack((i * 7) % (SIZE / 2));
+        }
+        // Ключи сортируются один раз, повторы удаляются
+        FlatSet<int> set(std::move(keys));
+        assert(set.Size() == SIZE / 2);
+        assert(std::is_sorted(set.begin(), set.end()));
+        for (int i = 0; i < SIZE / 2; ++i) {
+            assert(set.Contains(i) && *set.Find(i) == i);
+        }
+        assert(!set.Contains(-1) && !set.Contains(SIZE / 2) && set.Find(SIZE) == set.end());
+        assert(*set.LowerBound(-5) == 0 && set.LowerBound(SIZE) == set.end());
+
+        auto [it, inserted] = set.Insert(SIZE);
+        assert(inserted && *it == SIZE && it == set.end() - 1);
+        assert(!set.Insert(10).second && set.Size() == SIZE / 2 + 1);
+        assert(set.Insert(-1).first == set.begin());
+        assert(set.Erase(10) == 1 && set.Erase(10) == 0 && !set.Contains(10));
+        assert(set.Size() == SIZE / 2 + 1);
+        set.Erase(set.begin());
+        assert(*set.begin() == 0);
+
+        FlatSet<int, std::greater<int>> desc{3, 1, 2, 3};
+        assert(desc.Size() == 3 && *desc.begin() == 3 && desc.Contains(1));
+        FlatSet<int> sorted(SORTED_UNIQUE, Vector<int>{1, 2, 5});
+        assert(sorted.Contains(5) && !sorted.Contains(3) && *sorted.LowerBound(3) == 5);
+        FlatSet<int> empty;
+        assert(empty.Find(1) == empty.end() && empty.Erase(1) == 0);
+    }
+    {
+        Vector<std::string> keys;
+        Vector<int> values;
+        for (int i = SIZE - 1; i >= 0; --i) {
+            keys.PushBack(std::to_string(i % (SIZE / 2)));
+            values.PushBack(i);
+        }
+        // Из пар с одинаковыми ключами остаётся первая
+        FlatMap<std::string, int> map(std::move(keys), std::move(values));
+        assert(map.Size() == SIZE / 2);
+        assert(std::is_sorted(map.GetKeys().begin(), map.GetKeys().end()));
+        assert(map.At("0") == SIZE / 2 && *map.Find("499") == SIZE - 1);
+        assert(map.Find("1000") == nullptr && !map.Contains("-1"));
+        try {
+            map.At("x");
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+
+        assert(map.Insert("x", 1) && !map.Insert("x", 2) && map.At("x") == 1);
+        map.InsertOrAssign("x", 3);
+        assert(map.At("x") == 3);
+        assert(map["new"] == 0 && map.Size() == SIZE / 2 + 2);
+        map["new"] = 5;
+        auto [value, inserted] = map.TryEmplace("new", 6);
+        assert(!inserted && value == 5);
+        assert(map.Erase("new") == 1 && map.Erase("new") == 0 && map.Size() == SIZE / 2 + 1);
+        for (int& v : map.GetValues()) {
+            v = -v;
+        }
+        assert(map.At("1") == -(SIZE / 2 + 1));
+        // Индексы ключей и значений совпадают
+        const size_t index = map.LowerBound("1");
+        assert(map.GetKeys()[index] == "1" && map.GetValues()[index] == -(SIZE / 2 + 1));
+
+        const FlatMap<std::string, int> init{{"b", 2}, {"a", 1}, {"b", 3}};
+        assert(init.Size() == 2 && init.At("b") == 2 && *init.Find("a") == 1);
+    }
+    {
+        // Если создание значения выбросит исключение, отображение не меняется
+        Obj::ResetCounters();
+        FlatMap<int, Obj> map;
+        map.TryEmplace(1, 1);
+        map.TryEmplace(3, 3);
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            map[2];
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(map.Size() == 2 && !map.Contains(2) && map.GetValues()[1].id == 3);
+    }
+}
+
+// Таблица, построенная во время компиляции
+constexpr ConstexprStaticVector<int, 16> MakeSquares() {
+    ConstexprStaticVector<int, 16> squares;
+    for (int i = 0; i < 10; ++i) {
+        squares.PushBack(i * i);
+    }
+    squares.Insert(squares.cbegin() + 2, -1);
+    squares.Erase(squares.cbegin() + 2);
+    squares.Emplace(squares.cbegin(), squares[9]);
+    squares.PopBack();
+    return squares;
+}
+
+// Обмен вектора с более длинным во время компиляции
+constexpr int SwapWithLonger() {
+    ConstexprStaticVector<int, 4> lhs{1, 2};
+    ConstexprStaticVector<int, 4> rhs{3, 4, 5};
+    lhs.Swap(rhs);
+    return lhs.Size() == 3 && rhs.Size() == 2 ? lhs[0] * 100 + lhs[2] * 10 + rhs[1] : -1;
+}
+
+#if VECTOR_CONSTEXPR_ALLOC
+// В C++20 Vector создаётся, изменяется и уничтожается во время компиляции
+constexpr int SumAfterVectorOps() {
+    Vector<int> v{1, 2, 3};
+    for (int i = 4; i <= 10; ++i) {
+        v.PushBack(i);
+    }
+    v.Insert(v.cbegin() + 1, v[9]);
+    v.Erase(v.cbegin());
+    v.Erase(v.cbegin() + 1, v.cbegin() + 3);
+    v.Resize(10, 1);
+    Vector<int> copy = v;
+    copy.Assign(3, 5);
+    Vector<int> moved = std::move(copy);
+    moved.Swap(v);
+    moved.PopBack();
+
+    Vector<Vector<int>> nested;
+    nested.EmplaceBack(moved);
+    nested.EmplaceBack(std::move(v));
+    nested.Insert(nested.cbegin(), Vector<int>{2, 7});
+    nested.Reserve(8);
+    int sum = 0;
+    for (const Vector<int>& inner : nested) {
+        for (const int value : inner) {
+            sum += value;
+        }
+    }
+    return sum;
+}
+#endif
+
+// StaticVector
+void Test34() {
+    {
+        constexpr ConstexprStaticVector<int, 16> SQUARES = MakeSquares();
+        static_assert(SQUARES.Size() == 10 && SQUARES[0] == 81 && SQUARES[1] == 0 && SQUARES[9] == 64);
+        static_assert(ConstexprStaticVector<int, 4>{1, 2, 3}.Size() == 3);
+        static_assert(StaticVector<int, 16>::Capacity() == 16);
+        // Элементы хранятся внутри объекта
+        static_assert(sizeof(StaticVector<int, 16>) == 16 * sizeof(int) + sizeof(size_t));
+        static_assert(sizeof(ConstexprStaticVector<int, 16>) == sizeof(StaticVector<int, 16>));
+        static_assert(SwapWithLonger() == 352);
+#if VECTOR_CONSTEXPR_ALLOC
+        // 10 4 5 6 7 8 9 10 1, затем 5 5 5 и 2 7
+        static_assert(SumAfterVectorOps() == 84);
+#endif
+
+        ConstexprStaticVector<int, 16> copy = SQUARES;
+        copy.Resize(16, 7);
+        assert(copy[15] == 7 && copy.Size() == copy.Capacity());
+        try {
+            copy.PushBack(1);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(copy.Size() == 16);
+        copy.Erase(copy.cbegin(), copy.cbegin() + 10);
+        assert(copy.Size() == 6 && copy[0] == 7);
+        copy = SQUARES;
+        assert(copy.Size() == 10 && copy[9] == 64);
+
+        // Во время выполнения элементы сдвигаются так же, как в Vector
+        StaticVector<int, 16> squares;
+        for (const int value : SQUARES) {
+            squares.PushBack(value);
+        }
+        squares.Insert(squares.cbegin() + 1, squares[9]);
+        assert(squares.Size() == 11 && squares[1] == 64 && squares[2] == 0 && squares[10] == 64);
+        squares.Erase(squares.cbegin(), squares.cbegin() + 2);
+        assert(squares.Size() == 9 && squares[0] == 0 && squares[8] == 64);
+    }
+    {
+        // Тривиально перемещаемые элементы сдвигаются при вставке без вызова перемещения
+        StaticVector<Handle, 4> handles;
+        handles.EmplaceBack(1);
+        handles.EmplaceBack(2);
+        Handle::num_moved = 0;
+        handles.Emplace(handles.cbegin(), 0);
+        assert(Handle::num_moved == 0 && *handles[0].ptr == 0 && *handles[2].ptr == 2);
+        handles.Erase(handles.cbegin());
+        assert(handles.Size() == 2 && *handles[0].ptr == 1 && *handles[1].ptr == 2);
+    }
+    {
+        const size_t SIZE = 8;
+        Obj::ResetCounters();
+        {
+            StaticVector<Obj, SIZE> v(SIZE / 2);
+            assert(Obj::num_default_constructed == SIZE / 2);
+            v.EmplaceBack(1, "one");
+            v.Insert(v.cbegin(), v[4]);
+            assert(v[0].id == 1 && v[5].id == 1 && v.Size() == SIZE / 2 + 2);
+            v.Insert(v.cbegin() + 1, Obj(2));
+            assert(v[1].id == 2 && v[2].id == 0);
+            v.Erase(v.cbegin());
+            assert(v[0].id == 2 && v.Size() == SIZE / 2 + 2);
+
+            StaticVector<Obj, SIZE> copy(v);
+            assert(copy.Size() == v.Size() && copy[0].id == 2);
+            StaticVector<Obj, SIZE> moved(std::move(copy));
+            assert(moved.Size() == v.Size() && copy.Size() == 0);
+            copy = std::move(moved);
+            assert(copy[0].id == 2 && moved.Size() == 0);
+            copy.Resize(SIZE);
+            v = copy;
+            assert(v.Size() == SIZE && v[SIZE - 1].id == 0);
+            // Swap обменивает общую часть и переносит остаток более длинного вектора
+            StaticVector<Obj, SIZE> other(2);
+            other[0].id = 5;
+            v.Swap(other);
+            assert(v.Size() == 2 && v[0].id == 5 && other.Size() == SIZE && other[SIZE - 1].id == 0);
+            other.Swap(v);
+            assert(v.Size() == SIZE && other.Size() == 2 && other[0].id == 5);
+            v.Reserve(SIZE);
+            try {
+                v.Reserve(SIZE + 1);
+                assert(false);
+            } catch (const std::length_error&) {
+            }
+            v.Erase(v.cbegin() + 1, v.cend());
+            assert(v.Size() == 1 && v[0].id == 2);
+            other.Clear();
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + 1));
+
+            // Исключение при создании элементов не меняет вектор
+            Obj::default_construction_throw_countdown = 2;
+            try {
+                v.Resize(SIZE);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 1 && Obj::GetAliveObjectCount() == static_cast<int>(SIZE + 1));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+// CachingAllocator
+void Test35() {
+    using CachedVector = Vector<int, CachingAllocator<int>>;
+    BufferCache& cache = GetThreadBufferCache();
+    cache.Trim();
+    cache.ResetStats();
+    {
+        // Буферы одного размерного класса переиспользуются
+        for (int i = 0; i < 100; ++i) {
+            CachedVector v(100 + i % 20);
+            v[0] = i;
+        }
+        const BufferCacheStats& stats = cache.GetStats();
+        assert(stats.misses == 1 && stats.hits == 99 && stats.returned == 100);
+        assert(stats.HitRate() > 0.98 && stats.cached_bytes == 512);
+
+        CachedVector a(100);
+        CachedVector b(100);
+        assert(cache.GetStats().misses == 2 && cache.GetStats().cached_bytes == 0);
+        // Блок из кеша используется для меньшего размера того же класса
+        a = CachedVector();
+        CachedVector c(65);
+        assert(cache.GetStats().hits == 101 && cache.GetStats().cached_bytes == 0);
+    }
+    {
+        cache.Trim();
+        cache.ResetStats();
+        cache.SetLimits({1, size_t{1} << 20});
+        {
+            CachedVector a(10);
+            CachedVector b(10);
+        }
+        assert(cache.GetStats().returned == 1 && cache.GetStats().dropped == 1);
+        // Большие буферы не кешируются
+        {
+            CachedVector big(BufferCache::MAX_BLOCK_SIZE);
+        }
+        assert(cache.GetStats().bypassed == 1 && cache.GetStats().cached_bytes == 64);
+        cache.SetLimits(BufferCacheLimits());
+    }
+    {
+        // Буфер, выделенный в одном потоке, освобождается в другом и попадает в его кеш
+        cache.Trim();
+        cache.ResetStats();
+        CachedVector v;
+        std::thread([&v] {
+            v.Resize(1000);
+            std::iota(v.begin(), v.end(), 0);
+            assert(GetThreadBufferCache().GetStats().misses == 1);
+        }).join();
+        assert(v[999] == 999);
+        v.ReleaseMemory();
+        assert(cache.GetStats().returned == 1 && cache.GetStats().cached_bytes == 4096);
+        cache.Trim(1024);
+        assert(cache.GetStats().cached_bytes == 0);
     }
 }
 
@@ -647,7 +2605,37 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+#ifdef ADVANCED_VECTOR_STATS
+        Test16();
+#endif
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
+        Test35();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
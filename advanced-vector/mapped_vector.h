@@ -0,0 +1,310 @@
+#pragma once
+#include "vector.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+// Заголовок файла MappedVector. Элементы следуют сразу за ним
+struct MappedVectorHeader {
+    static constexpr uint64_t MAGIC = 0x524f5443'45564441;  // "ADVECTOR"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t element_size = 0;
+    uint64_t size = 0;
+    uint64_t capacity = 0;
+};
+
+// Место под заголовок, сохраняющее выравнивание элементов
+inline constexpr size_t MAPPED_VECTOR_HEADER_SIZE = 64;
+static_assert(sizeof(MappedVectorHeader) <= MAPPED_VECTOR_HEADER_SIZE);
+
+// Сырая память под capacity элементов, отображённая из файла.
+// Повторяет интерфейс RawMemory, а вместимость и размер хранит в заголовке файла
+template <typename T>
+class MappedMemory {
+    static_assert(alignof(T) <= MAPPED_VECTOR_HEADER_SIZE);
+
+public:
+    MappedMemory() = default;
+
+    // Открывает файл или создаёт пустой. Страницы существующего файла не читаются заранее,
+    // а подгружаются системой при первом обращении
+    explicit MappedMemory(const std::string& path) {
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "Can't open " + path);
+        }
+        try {
+            struct stat st {};
+            if (fstat(fd_, &st) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Can't stat " + path);
+            }
+            if (st.st_size == 0) {
+                Truncate(MappingSize(0));
+                Map(MappingSize(0));
+                MappedVectorHeader header;
+                header.element_size = sizeof(T);
+                GetHeader() = header;
+            } else {
+                const size_t file_size = static_cast<size_t>(st.st_size);
+                if (file_size < MAPPED_VECTOR_HEADER_SIZE) {
+                    throw std::runtime_error(path + " is not a vector file");
+                }
+                Map(file_size);
+                const MappedVectorHeader& header = GetHeader();
+                if (header.magic != MappedVectorHeader::MAGIC || header.version != MappedVectorHeader::VERSION) {
+                    throw std::runtime_error(path + " is not a vector file");
+                }
+                if (header.element_size != sizeof(T)) {
+                    throw std::runtime_error(path + " stores elements of another size");
+                }
+                // Вместимость из файла не умножается на sizeof(T), чтобы повреждённый заголовок не вызвал переполнения
+                if (header.size > header.capacity
+                    || header.capacity > (file_size - MAPPED_VECTOR_HEADER_SIZE) / sizeof(T)) {
+                    throw std::runtime_error(path + " is truncated");
+                }
+            }
+        } catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    MappedMemory(const MappedMemory&) = delete;
+    MappedMemory& operator=(const MappedMemory&) = delete;
+    MappedMemory(MappedMemory&& other) noexcept {
+        Swap(other);
+    }
+    MappedMemory& operator=(MappedMemory&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~MappedMemory() {
+        Close();
+    }
+
+    T* operator+(size_t offset) noexcept {
+        assert(offset <= Capacity());
+        return GetAddress() + offset;
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < Capacity());
+        return GetAddress()[index];
+    }
+
+    void Swap(MappedMemory& other) noexcept {
+        std::swap(fd_, other.fd_);
+        std::swap(mapping_, other.mapping_);
+        std::swap(mapping_size_, other.mapping_size_);
+    }
+
+    T* GetAddress() noexcept {
+        return reinterpret_cast<T*>(mapping_ + MAPPED_VECTOR_HEADER_SIZE);
+    }
+
+    size_t Capacity() const noexcept {
+        return mapping_ != nullptr ? GetHeader().capacity : 0;
+    }
+
+    MappedVectorHeader& GetHeader() noexcept {
+        return *reinterpret_cast<MappedVectorHeader*>(mapping_);
+    }
+    const MappedVectorHeader& GetHeader() const noexcept {
+        return *reinterpret_cast<const MappedVectorHeader*>(mapping_);
+    }
+
+    // Изменяет размер файла и отображения. Содержимое сохраняется без копирования,
+    // адрес элементов может измениться. При исключении память не меняется
+    void Reallocate(size_t new_capacity) {
+        const size_t new_size = MappingSize(new_capacity);
+        const size_t old_size = mapping_size_;
+        Truncate(new_size);
+        void* p = mremap(mapping_, old_size, new_size, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            const int error = errno;
+            [[maybe_unused]] const int rc = ftruncate(fd_, static_cast<off_t>(old_size));
+            throw std::system_error(error, std::generic_category(), "Can't remap vector file");
+        }
+        mapping_ = static_cast<std::byte*>(p);
+        mapping_size_ = new_size;
+        GetHeader().capacity = new_capacity;
+    }
+
+    // Синхронно записывает изменённые страницы на диск
+    void Flush() {
+        if (mapping_ != nullptr && msync(mapping_, mapping_size_, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Can't flush vector file");
+        }
+    }
+
+private:
+    static size_t MappingSize(size_t capacity) {
+        if (capacity > (std::numeric_limits<size_t>::max() - MAPPED_VECTOR_HEADER_SIZE) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return MAPPED_VECTOR_HEADER_SIZE + capacity * sizeof(T);
+    }
+
+    void Truncate(size_t size) {
+        if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Can't resize vector file");
+        }
+    }
+
+    void Map(size_t size) {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "Can't map vector file");
+        }
+        mapping_ = static_cast<std::byte*>(p);
+        mapping_size_ = size;
+    }
+
+    void Close() noexcept {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, mapping_size_);
+            mapping_ = nullptr;
+            mapping_size_ = 0;
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    int fd_ = -1;
+    std::byte* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+};
+
+// Вектор тривиально копируемых элементов, хранящихся в файле.
+// Открытие существующего файла не копирует данные, а изменения попадают в файл напрямую.
+// Элементы не уничтожаются при закрытии: их время жизни совпадает со временем жизни файла.
+// Чтобы изменения гарантированно оказались на диске, нужно вызвать Flush
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores trivially copyable types only");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    explicit MappedVector(const std::string& path)
+    : data_(path) {
+    }
+
+    iterator begin() noexcept {
+        return data_.GetAddress();
+    }
+    iterator end() noexcept {
+        return data_.GetAddress() + Size();
+    }
+    const_iterator begin() const noexcept {
+        return const_cast<MappedVector&>(*this).begin();
+    }
+    const_iterator end() const noexcept {
+        return const_cast<MappedVector&>(*this).end();
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        // У перемещённого вектора нет отображения и заголовка
+        return data_.Capacity() != 0 ? data_.GetHeader().size : 0;
+    }
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<MappedVector&>(*this)[index];
+    }
+    T& operator[](size_t index) noexcept {
+        assert(index < Size());
+        return data_[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > Capacity()) {
+            data_.Reallocate(new_capacity);
+        }
+    }
+
+    void Resize(size_t new_size) {
+        Resize(new_size, T{});
+    }
+    void Resize(size_t new_size, T value) {
+        if (new_size > Size()) {
+            Reserve(new_size);
+            std::uninitialized_fill(end(), begin() + new_size, value);
+        }
+        SetSize(new_size);
+    }
+
+    void Clear() noexcept {
+        SetSize(0);
+    }
+
+    void PushBack(T value) {
+        EmplaceBack(value);
+    }
+
+    void PopBack() noexcept {
+        if (Size() != 0) {
+            SetSize(Size() - 1);
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        // Элемент создаётся заранее: аргументы могут ссылаться на элементы, которые переместит Reallocate
+        T value(std::forward<Args>(args)...);
+        if (Size() == Capacity()) {
+            const size_t new_capacity = GrowthPolicy::NextCapacity(Size(), sizeof(T));
+            assert(new_capacity > Size());
+            data_.Reallocate(new_capacity);
+        }
+        T* elem = new (end()) T(value);
+        SetSize(Size() + 1);
+        return *elem;
+    }
+
+    // Освобождает неиспользуемую часть файла
+    void ShrinkToFit() {
+        if (Size() != Capacity()) {
+            data_.Reallocate(Size());
+        }
+    }
+
+    void Flush() {
+        data_.Flush();
+    }
+
+private:
+    void SetSize(size_t size) noexcept {
+        data_.GetHeader().size = size;
+    }
+
+private:
+    MappedMemory<T> data_;
+};
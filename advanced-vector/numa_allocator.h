@@ -0,0 +1,239 @@
+#pragma once
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Размещение памяти вектора по узлам NUMA (Linux). Политика задаётся аллокатором:
+// Vector<T, NumaAllocator<T>> v(size, NumaAllocator<T>(NumaPolicy::Bind(0))).
+// Системные вызовы mbind и move_pages вызываются напрямую, поэтому libnuma не нужна.
+// Буферы отображаются через mmap целыми страницами, так что аллокатор рассчитан на большие векторы
+
+enum class NumaMode {
+    // Страница размещается на узле потока, первым обратившегося к ней
+    FIRST_TOUCH,
+    // Все страницы размещаются на узлах из маски
+    BIND,
+    // Страницы распределяются по узлам из маски по очереди
+    INTERLEAVE,
+};
+
+namespace numa_detail {
+
+// Число узлов, которые помещаются в маску NumaPolicy::nodes
+inline constexpr size_t MAX_NODES = 64;
+
+}  // namespace numa_detail
+
+struct NumaPolicy {
+    NumaMode mode = NumaMode::FIRST_TOUCH;
+    // Маска узлов для BIND и INTERLEAVE: бит i соответствует узлу i.
+    // Пустую маску ядро отклоняет как любую недопустимую политику
+    uint64_t nodes = 0;
+    // Для FIRST_TOUCH: число потоков, которые при выделении заранее обращаются к своим частям буфера,
+    // распределяя страницы по узлам, на которых эти потоки выполняются. 0 — не обращаться
+    unsigned first_touch_threads = 0;
+    // Для BIND и INTERLEAVE: выбрасывать std::system_error, если ядро отклонило политику.
+    // Иначе память остаётся с политикой по умолчанию, а отказ учитывается в NumaPolicyFailures
+    bool strict = false;
+
+    // Узел, не помещающийся в маску, даёт пустую маску, и выделение учитывается как отказ политики
+    static NumaPolicy Bind(unsigned node) noexcept {
+        return {NumaMode::BIND, node < numa_detail::MAX_NODES ? uint64_t{1} << node : 0, 0};
+    }
+    static NumaPolicy Interleave(uint64_t nodes) noexcept {
+        return {NumaMode::INTERLEAVE, nodes, 0};
+    }
+    static NumaPolicy FirstTouch(unsigned threads = 0) noexcept {
+        return {NumaMode::FIRST_TOUCH, 0, threads};
+    }
+    // Та же политика, отказ в которой выбрасывает исключение
+    NumaPolicy Strict() const noexcept {
+        NumaPolicy policy = *this;
+        policy.strict = true;
+        return policy;
+    }
+
+    bool operator==(const NumaPolicy& other) const noexcept {
+        return mode == other.mode && nodes == other.nodes && first_touch_threads == other.first_touch_threads
+               && strict == other.strict;
+    }
+    bool operator!=(const NumaPolicy& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+namespace numa_detail {
+
+// Значения MPOL_* из linux/mempolicy.h
+inline constexpr int MPOL_BIND_MODE = 2;
+inline constexpr int MPOL_INTERLEAVE_MODE = 3;
+
+inline size_t PageSize() noexcept {
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+inline size_t RoundToPages(size_t bytes) noexcept {
+    return (bytes + PageSize() - 1) / PageSize() * PageSize();
+}
+
+inline void TouchPages(void* p, size_t first, size_t last) noexcept {
+    for (size_t page = first; page < last; ++page) {
+        static_cast<volatile std::byte*>(p)[page * PageSize()] = std::byte{0};
+    }
+}
+
+// Потоки обращаются к страницам своих непрерывных частей буфера.
+// Если поток не удалось создать, оставшиеся страницы обходит вызывающий поток
+inline void ParallelFirstTouch(void* p, size_t bytes, unsigned threads) {
+    const size_t pages = bytes / PageSize();
+    const size_t per_thread = (pages + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t first = 0; first < pages; first += per_thread) {
+        const size_t last = std::min(pages, first + per_thread);
+        try {
+            workers.emplace_back(TouchPages, p, first, last);
+        } catch (const std::system_error&) {
+            TouchPages(p, first, pages);
+            break;
+        }
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+inline std::atomic<size_t>& PolicyFailureCounter() noexcept {
+    static std::atomic<size_t> failures = 0;
+    return failures;
+}
+
+}  // namespace numa_detail
+
+// Число выделений, для которых ядро отклонило политику BIND или INTERLEAVE
+inline size_t NumaPolicyFailures() noexcept {
+    return numa_detail::PolicyFailureCounter().load(std::memory_order_relaxed);
+}
+
+// Узел NUMA, на котором размещена страница с адресом p,
+// либо -1, если страница ещё не отображена или ядро не поддерживает запрос
+inline int NumaNodeOf(const void* p) noexcept {
+    void* page = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(p) / numa_detail::PageSize() *
+                                         numa_detail::PageSize());
+    int status = -1;
+    if (syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &status, 0) != 0 || status < 0) {
+        return -1;
+    }
+    return status;
+}
+
+// Число отображённых страниц диапазона [p, p + bytes) на каждом узле NUMA: элемент i соответствует узлу i
+inline std::vector<size_t> NumaPagesPerNode(const void* p, size_t bytes) {
+    const size_t page_size = numa_detail::PageSize();
+    const uintptr_t first = reinterpret_cast<uintptr_t>(p) / page_size * page_size;
+    const uintptr_t last = reinterpret_cast<uintptr_t>(p) + bytes;
+    std::vector<void*> pages;
+    for (uintptr_t page = first; page < last; page += page_size) {
+        pages.push_back(reinterpret_cast<void*>(page));
+    }
+    std::vector<int> status(pages.size(), -1);
+    std::vector<size_t> result;
+    if (pages.empty() || syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+        return result;
+    }
+    for (const int node : status) {
+        if (node >= 0) {
+            result.resize(std::max(result.size(), static_cast<size_t>(node) + 1));
+            ++result[static_cast<size_t>(node)];
+        }
+    }
+    return result;
+}
+
+// Аллокатор, размещающий буферы согласно NumaPolicy. Освободить буфер может любой экземпляр,
+// а политика распространяется вместе с буфером при присваивании и обмене векторов.
+// Экземпляры с разными политиками не равны, поэтому копирующее присваивание не переиспользует
+// буфер, размещённый по прежней политике
+template <typename T>
+class NumaAllocator {
+public:
+    using value_type = T;
+    using is_always_equal = std::false_type;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    NumaAllocator() = default;
+    explicit NumaAllocator(NumaPolicy policy) noexcept
+    : policy_(policy) {
+    }
+    template <typename U>
+    NumaAllocator(const NumaAllocator<U>& other) noexcept  // NOLINT
+    : policy_(other.GetPolicy()) {
+    }
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t));
+        if (n > (std::numeric_limits<size_t>::max() - numa_detail::PageSize()) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t size = numa_detail::RoundToPages(n * sizeof(T));
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        // Политика применяется к ещё не отображённым страницам, поэтому задаётся до первого обращения
+        if (policy_.mode != NumaMode::FIRST_TOUCH) {
+            const int mode = policy_.mode == NumaMode::BIND ? numa_detail::MPOL_BIND_MODE
+                                                            : numa_detail::MPOL_INTERLEAVE_MODE;
+            // Ядро считает maxnode номером бита после последнего узла маски
+            if (syscall(SYS_mbind, p, size, mode, &policy_.nodes, numa_detail::MAX_NODES + 1, 0U) != 0) {
+                const int error = errno;
+                numa_detail::PolicyFailureCounter().fetch_add(1, std::memory_order_relaxed);
+                if (policy_.strict) {
+                    munmap(p, size);
+                    throw std::system_error(error, std::generic_category(), "Can't apply NUMA policy");
+                }
+            }
+        } else if (policy_.first_touch_threads > 1) {
+            try {
+                numa_detail::ParallelFirstTouch(p, size, policy_.first_touch_threads);
+            } catch (...) {
+                munmap(p, size);
+                throw;
+            }
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        munmap(p, numa_detail::RoundToPages(n * sizeof(T)));
+    }
+
+    const NumaPolicy& GetPolicy() const noexcept {
+        return policy_;
+    }
+
+    bool operator==(const NumaAllocator& other) const noexcept {
+        return policy_ == other.policy_;
+    }
+    bool operator!=(const NumaAllocator& other) const noexcept {
+        return !(*this == other);
+    }
+
+private:
+    NumaPolicy policy_;
+};
@@ -0,0 +1,243 @@
+#pragma once
+#include "index_iterator.h"
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Размер блока SegmentedVector по умолчанию
+inline constexpr size_t SEGMENT_BYTES = 4096;
+
+// Вектор, хранящий элементы в блоках RawMemory по BlockSize элементов.
+// Рост добавляет новый блок и не переносит существующие элементы, поэтому время PushBack
+// ограничено, а ссылки и указатели на элементы остаются действительными до их удаления.
+// Переносятся только указатели на блоки в каталоге, которых в BlockSize раз меньше, чем элементов.
+// Элементы никогда не переносятся, поэтому EmplaceBack и Resize дают строгую гарантию безопасности исключений
+// для любых T, даже с бросающим перемещением
+template <typename T, size_t BlockSize = std::max<size_t>(1, SEGMENT_BYTES / sizeof(T)),
+          typename Allocator = std::allocator<T>>
+class SegmentedVector {
+    static_assert(BlockSize > 0);
+
+    using Block = RawMemory<T, Allocator>;
+    using AllocTraits = std::allocator_traits<Allocator>;
+
+public:
+    using iterator = IndexIterator<SegmentedVector, T, T&, T*>;
+    using const_iterator = IndexIterator<const SegmentedVector, T, const T&, const T*>;
+    using allocator_type = Allocator;
+
+    static constexpr size_t BLOCK_SIZE = BlockSize;
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+    iterator end() noexcept {
+        return {this, size_};
+    }
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+public:
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Allocator& alloc) noexcept
+    : alloc_(alloc) {
+    }
+
+    explicit SegmentedVector(size_t size, const Allocator& alloc = Allocator())
+    : SegmentedVector(alloc)  //
+    {
+        Resize(size);
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+    : SegmentedVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))  //
+    {
+    }
+    // Делегирующий конструктор гарантирует вызов деструктора, если копирование элемента выбросит исключение
+    SegmentedVector(const SegmentedVector& other, const Allocator& alloc)
+    : SegmentedVector(alloc)  //
+    {
+        Reserve(other.size_);
+        for (const T& elem : other) {
+            EmplaceBack(elem);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+    : blocks_(std::move(other.blocks_))
+    , size_(std::exchange(other.size_, 0))
+    , alloc_(other.alloc_) {
+    }
+
+    // Как и в Vector, аллокатор источника переходит к вектору, только если это разрешают его признаки,
+    // иначе новые блоки выделяются собственным аллокатором
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            constexpr bool PROPAGATE = AllocTraits::propagate_on_container_copy_assignment::value;
+            SegmentedVector rhs_copy(rhs, PROPAGATE ? rhs.GetAllocator() : GetAllocator());
+            AdoptBlocks(rhs_copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                               || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                          || AllocTraits::is_always_equal::value) {
+                AdoptBlocks(rhs);
+            } else if (alloc_ == rhs.alloc_) {
+                AdoptBlocks(rhs);
+            } else {
+                // Блоки другого аллокатора забрать нельзя, поэтому элементы перемещаются по одному
+                SegmentedVector moved(alloc_);
+                moved.Reserve(rhs.size_);
+                for (T& elem : rhs) {
+                    moved.EmplaceBack(std::move(elem));
+                }
+                AdoptBlocks(moved);
+                rhs.Clear();
+            }
+        }
+        return *this;
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        } else {
+            // Обмен векторов с неравными непередаваемыми аллокаторами не поддерживается
+            assert(AllocTraits::is_always_equal::value || alloc_ == other.alloc_);
+        }
+        blocks_.Swap(other.blocks_);
+        std::swap(size_, other.size_);
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+    size_t Capacity() const noexcept {
+        return blocks_.Size() * BlockSize;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return blocks_[index / BlockSize][index % BlockSize];
+    }
+
+    // Выделяет блоки заранее. Существующие элементы не переносятся
+    void Reserve(size_t new_capacity) {
+        blocks_.Reserve((new_capacity + BlockSize - 1) / BlockSize);
+        while (Capacity() < new_capacity) {
+            AddBlock();
+        }
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            while (size_ > new_size) {
+                PopBack();
+            }
+        } else {
+            Reserve(new_size);
+            // Уже созданные в этом вызове элементы удаляются, если следующий выбросит исключение
+            const size_t old_size = size_;
+            try {
+                while (size_ < new_size) {
+                    EmplaceBack();
+                }
+            } catch (...) {
+                Resize(old_size);
+                throw;
+            }
+        }
+    }
+
+    void Clear() noexcept {
+        while (size_ != 0) {
+            PopBack();
+        }
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Новый блок выделяется до создания элемента, поэтому аргументы могут ссылаться на элементы
+    // вектора: их адреса не меняются
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            AddBlock();
+        }
+        T* elem = new (blocks_[size_ / BlockSize] + size_ % BlockSize) T(std::forward<Args>(args)...);
+        ++size_;
+        return *elem;
+    }
+
+    void PopBack() noexcept {
+        if (size_ != 0) {
+            --size_;
+            std::destroy_at(blocks_[size_ / BlockSize] + size_ % BlockSize);
+        }
+    }
+
+    // Освобождает блоки, не занятые элементами
+    void ShrinkToFit() {
+        const size_t used_blocks = (size_ + BlockSize - 1) / BlockSize;
+        blocks_.Resize(used_blocks);
+        blocks_.ShrinkToFit();
+    }
+
+    ~SegmentedVector() {
+        Clear();
+    }
+
+private:
+    // Забирает блоки other. Аллокатор other переходит к вектору, если это разрешают признаки
+    // распространения при присваивании, поэтому other должен использовать совместимый аллокатор
+    void AdoptBlocks(SegmentedVector& other) noexcept {
+        Clear();
+        blocks_ = std::move(other.blocks_);
+        size_ = std::exchange(other.size_, 0);
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value
+                      || AllocTraits::propagate_on_container_move_assignment::value) {
+            alloc_ = other.alloc_;
+        }
+    }
+
+    void AddBlock() {
+        blocks_.EmplaceBack(BlockSize, alloc_);
+    }
+
+private:
+    Vector<Block> blocks_;
+    size_t size_ = 0;
+    Allocator alloc_;
+};
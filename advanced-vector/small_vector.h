@@ -0,0 +1,223 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+// Вектор со встроенным буфером на N элементов. Пока размер не превышает N,
+// элементы хранятся внутри объекта без обращения к куче, а при росте переносятся в RawMemory.
+// Reserve и вставка дают строгую гарантию безопасности исключений, как у Vector.
+// В отличие от Vector, перемещение и обмен переносят элементы встроенного буфера по одному:
+// источник перемещения становится пустым, а если перемещение элемента выбросит исключение,
+// гарантия только базовая
+template <typename T, size_t N, typename GrowthPolicy = DoublingGrowth>
+class SmallVector {
+    static_assert(N > 0, "Use Vector for containers without inline storage");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    iterator begin() noexcept {
+        return Data();
+    }
+    iterator end() noexcept {
+        return Data() + size_;
+    }
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+    const_iterator cbegin() const noexcept {
+        return Data();
+    }
+    const_iterator cend() const noexcept {
+        return Data() + size_;
+    }
+
+public:
+    SmallVector() = default;
+
+    explicit SmallVector(size_t size) {
+        Reserve(size);
+        std::uninitialized_value_construct_n(Data(), size);
+        size_ = size;
+    }
+    SmallVector(const SmallVector& other) {
+        Reserve(other.size_);
+        std::uninitialized_copy_n(other.Data(), other.size_, Data());
+        size_ = other.size_;
+    }
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (other.IsInline()) {
+            std::uninitialized_move_n(other.Data(), other.size_, Data());
+            size_ = other.size_;
+            other.Resize(0);
+        } else {
+            heap_ = std::move(other.heap_);
+            size_ = std::exchange(other.size_, 0);
+        }
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            if (rhs.size_ > Capacity()) {
+                SmallVector rhs_copy(rhs);
+                Swap(rhs_copy);
+            } else {
+                const size_t common = std::min(size_, rhs.size_);
+                std::copy_n(rhs.Data(), common, Data());
+                if (rhs.size_ < size_) {
+                    std::destroy_n(Data() + rhs.size_, size_ - rhs.size_);
+                } else {
+                    std::uninitialized_copy_n(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+                }
+                size_ = rhs.size_;
+            }
+        }
+        return *this;
+    }
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            Resize(0);
+            if (rhs.IsInline()) {
+                // Вместимость любого SmallVector не меньше N, поэтому элементы помещаются без реаллокации
+                std::uninitialized_move_n(rhs.Data(), rhs.size_, Data());
+                size_ = rhs.size_;
+                rhs.Resize(0);
+            } else {
+                heap_ = std::move(rhs.heap_);
+                size_ = std::exchange(rhs.size_, 0);
+            }
+        }
+        return *this;
+    }
+
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (!IsInline() && !other.IsInline()) {
+            heap_.Swap(other.heap_);
+            std::swap(size_, other.size_);
+        } else {
+            SmallVector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+    size_t Capacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Элементы хранятся во встроенном буфере
+    bool IsInline() const noexcept {
+        return heap_.GetAddress() == nullptr;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SmallVector&>(*this)[index];
+    }
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+
+        RawMemory<T> new_data(new_capacity);
+        UninitializedRelocateN(Data(), size_, new_data.GetAddress());
+        heap_.Swap(new_data);
+    }
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            std::destroy_n(Data() + new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            Reserve(new_size);
+            std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+        }
+
+        size_ = new_size;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        if (size_ != 0) {
+            std::destroy_at(Data() + (size_ - 1));
+            --size_;
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            return *Emplace(end(), std::forward<Args>(args)...);
+        }
+        new (Data() + size_) T(std::forward<Args>(args)...);
+        ++size_;
+        return Data()[size_ - 1];
+    }
+
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t delta = pos - begin();
+
+        if (size_ == Capacity()) {
+            const size_t new_capacity = GrowthPolicy::NextCapacity(size_, sizeof(T));
+            assert(new_capacity > size_);
+            RawMemory<T> new_data(new_capacity);
+            new (new_data + delta) T(std::forward<Args>(args)...);
+            UninitializedRelocateAroundGap(Data(), size_, delta, 1, new_data.GetAddress());
+            heap_ = std::move(new_data);
+        } else {
+            EmplaceShifted(Data() + delta, end(), std::forward<Args>(args)...);
+        }
+
+        ++size_;
+        return begin() + delta;
+    }
+
+    iterator Erase(const_iterator pos) noexcept {
+        const size_t delta = pos - begin();
+        EraseN(begin() + delta, end(), 1);
+        --size_;
+        return begin() + delta;
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    ~SmallVector() {
+        std::destroy_n(Data(), size_);
+    }
+
+private:
+    T* Data() noexcept {
+        return IsInline() ? std::launder(reinterpret_cast<T*>(inline_)) : heap_.GetAddress();
+    }
+    const T* Data() const noexcept {
+        return const_cast<SmallVector&>(*this).Data();
+    }
+
+private:
+    alignas(T) std::byte inline_[N * sizeof(T)];
+    RawMemory<T> heap_;
+    size_t size_ = 0;
+};
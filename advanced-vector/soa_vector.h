@@ -0,0 +1,342 @@
+#pragma once
+#include "index_iterator.h"
+#include "vector.h"
+
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <utility>
+
+// Непрерывный диапазон элементов: данные одного столбца SoAVector
+template <typename T>
+class Span {
+public:
+    Span() = default;
+    Span(T* data, size_t size) noexcept
+    : data_(data)
+    , size_(size) {
+    }
+
+    T* begin() const noexcept {
+        return data_;
+    }
+    T* end() const noexcept {
+        return data_ + size_;
+    }
+    T* Data() const noexcept {
+        return data_;
+    }
+    size_t Size() const noexcept {
+        return size_;
+    }
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Вектор записей из полей Fields..., где каждое поле хранится в своём массиве RawMemory.
+// Циклы, читающие одно-два поля, не загружают в кеш остальные, и компилятор векторизует их.
+// Все столбцы растут вместе. Если создание поля выбросит исключение во время роста или добавления,
+// уже созданные поля этой записи во всех столбцах удаляются, и вектор не меняется.
+// Поля передаются последними, поэтому стратегия роста — первый параметр шаблона
+template <typename GrowthPolicy, typename... Fields>
+class BasicSoAVector {
+    static_assert(sizeof...(Fields) > 0);
+    // Перенос столбца при росте не должен выбрасывать исключений, иначе откатить уже перенесённые столбцы нельзя
+    static_assert(((std::is_nothrow_move_constructible_v<Fields> || std::is_copy_constructible_v<Fields>) && ...),
+                  "Fields with a throwing move must be copy constructible");
+
+    static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+    // Размер записи для стратегии роста: байты всех полей одного индекса
+    static constexpr size_t ROW_SIZE = (sizeof(Fields) + ...);
+    using Columns = std::tuple<RawMemory<Fields>...>;
+    using Indices = std::index_sequence_for<Fields...>;
+
+    // При переносе в новый буфер элементы столбца копируются, и копирование может выбросить исключение
+    template <typename T>
+    static constexpr bool COPIES_ON_TRANSFER = !IS_TRIVIALLY_RELOCATABLE<T> &&
+                                               !std::is_nothrow_move_constructible_v<T> &&
+                                               std::is_copy_constructible_v<T>;
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, value_type>;
+
+    // Итератор по записям: разыменование даёт кортеж ссылок на поля записи.
+    // Так как ссылка является прокси-объектом, алгоритмы, переставляющие элементы (std::sort), неприменимы
+    using iterator = IndexIterator<BasicSoAVector, value_type, reference, void>;
+    using const_iterator = IndexIterator<const BasicSoAVector, value_type, const_reference, void>;
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+    iterator end() noexcept {
+        return {this, size_};
+    }
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+public:
+    BasicSoAVector() = default;
+
+    explicit BasicSoAVector(size_t size)
+    : columns_(RawMemory<Fields>(size)...)
+    , capacity_(size) {
+        ConstructColumns(columns_, 0, size, [](auto column, auto* dest, size_t count) {
+            static_cast<void>(column);
+            std::uninitialized_value_construct_n(dest, count);
+            return true;
+        });
+        size_ = size;
+    }
+
+    BasicSoAVector(const BasicSoAVector& other)
+    : columns_(RawMemory<Fields>(other.size_)...)
+    , capacity_(other.size_) {
+        ConstructColumns(columns_, 0, other.size_, [&other](auto column, auto* dest, size_t count) {
+            std::uninitialized_copy_n(other.template Column<decltype(column)::value>().Data(), count, dest);
+            return true;
+        });
+        size_ = other.size_;
+    }
+
+    BasicSoAVector(BasicSoAVector&& other) noexcept
+    : columns_(std::move(other.columns_))
+    , size_(std::exchange(other.size_, 0))
+    , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    BasicSoAVector& operator=(const BasicSoAVector& rhs) {
+        if (this != &rhs) {
+            BasicSoAVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    BasicSoAVector& operator=(BasicSoAVector&& rhs) noexcept {
+        if (this != &rhs) {
+            BasicSoAVector tmp(std::move(rhs));
+            Swap(tmp);
+        }
+        return *this;
+    }
+
+    void Swap(BasicSoAVector& other) noexcept {
+        SwapColumns(other, Indices{});
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    // Непрерывный массив значений поля I всех записей
+    template <size_t I>
+    Span<FieldType<I>> Column() noexcept {
+        return {std::get<I>(columns_).GetAddress(), size_};
+    }
+    template <size_t I>
+    Span<const FieldType<I>> Column() const noexcept {
+        return {std::get<I>(columns_).GetAddress(), size_};
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return const_cast<BasicSoAVector&>(*this).Row(index, Indices{});
+    }
+
+    // Буферы всех столбцов выделяются до переноса элементов. Сначала копируются столбцы,
+    // копирование которых может выбросить исключение, и только затем без исключений переносятся остальные,
+    // поэтому при ошибке вектор остаётся прежним
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+
+        Columns new_columns{RawMemory<Fields>(new_capacity)...};
+        ConstructColumns(new_columns, 0, size_, [this](auto column, auto* dest, size_t count) {
+            using T = FieldType<decltype(column)::value>;
+            if constexpr (COPIES_ON_TRANSFER<T>) {
+                std::uninitialized_copy_n(std::get<decltype(column)::value>(columns_).GetAddress(), count, dest);
+                return true;
+            } else {
+                static_cast<void>(dest);
+                static_cast<void>(count);
+                return false;
+            }
+        });
+        TransferColumns(new_columns, Indices{});
+        columns_ = std::move(new_columns);
+        capacity_ = new_capacity;
+    }
+
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            DestroyRows(new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            Reserve(new_size);
+            ConstructColumns(columns_, size_, new_size - size_, [](auto column, auto* dest, size_t count) {
+                static_cast<void>(column);
+                std::uninitialized_value_construct_n(dest, count);
+                return true;
+            });
+        }
+        size_ = new_size;
+    }
+
+    void Clear() noexcept {
+        DestroyRows(0, size_);
+        size_ = 0;
+    }
+
+    void PushBack(const value_type& value) {
+        std::apply(
+            [this](const Fields&... fields) {
+                EmplaceBack(fields...);
+            },
+            value);
+    }
+    void PushBack(value_type&& value) {
+        std::apply(
+            [this](Fields&... fields) {
+                EmplaceBack(std::move(fields)...);
+            },
+            value);
+    }
+
+    // Добавляет запись, поле I которой конструируется из аргумента I
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == FIELD_COUNT, "EmplaceBack expects one argument per field");
+        if (size_ == capacity_) {
+            // Аргументы могут ссылаться на поля вектора, которые Reserve перенесёт
+            value_type tmp(std::forward<Args>(args)...);
+            Reserve(GrowthPolicy::NextCapacity(capacity_, ROW_SIZE));
+            std::apply(
+                [this](Fields&... fields) {
+                    ConstructFields<0>(size_, std::move(fields)...);
+                },
+                tmp);
+        } else {
+            ConstructFields<0>(size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PopBack() noexcept {
+        if (size_ != 0) {
+            --size_;
+            DestroyRows(size_, 1);
+        }
+    }
+
+    ~BasicSoAVector() {
+        DestroyRows(0, size_);
+    }
+
+private:
+    template <size_t... Is>
+    reference Row(size_t index, std::index_sequence<Is...> /*indices*/) noexcept {
+        return reference(std::get<Is>(columns_)[index]...);
+    }
+
+    template <size_t... Is>
+    void SwapColumns(BasicSoAVector& other, std::index_sequence<Is...> /*indices*/) noexcept {
+        (std::get<Is>(columns_).Swap(std::get<Is>(other.columns_)), ...);
+    }
+
+    // Вызывает construct(column, dest, count) для столбцов I, I + 1, ... таблицы to,
+    // где dest — адрес элемента first в столбце. construct возвращает, создал ли он элементы,
+    // и при исключении сам уничтожает созданное. Если столбец не создан, созданные ранее уничтожаются
+    template <size_t I = 0, typename Construct>
+    static void ConstructColumns(Columns& to, size_t first, size_t count, Construct&& construct) {
+        if constexpr (I < FIELD_COUNT) {
+            FieldType<I>* dest = std::get<I>(to) + first;
+            const bool constructed = construct(std::integral_constant<size_t, I>{}, dest, count);
+            try {
+                ConstructColumns<I + 1>(to, first, count, construct);
+            } catch (...) {
+                if (constructed) {
+                    std::destroy_n(dest, count);
+                }
+                throw;
+            }
+        }
+    }
+
+    // Переносит без исключений столбцы, которые не были скопированы, и уничтожает оригиналы скопированных
+    template <size_t... Is>
+    void TransferColumns(Columns& to, std::index_sequence<Is...> /*indices*/) noexcept {
+        (TransferColumn<Is>(std::get<Is>(to).GetAddress()), ...);
+    }
+
+    template <size_t I>
+    void TransferColumn(FieldType<I>* to) noexcept {
+        FieldType<I>* from = std::get<I>(columns_).GetAddress();
+        if constexpr (COPIES_ON_TRANSFER<FieldType<I>>) {
+            std::destroy_n(from, size_);
+        } else {
+            UninitializedRelocateN(from, size_, to);
+        }
+    }
+
+    // Конструирует поля I, I + 1, ... записи index. Если поле не создано, созданные ранее уничтожаются
+    template <size_t I, typename Arg, typename... Args>
+    void ConstructFields(size_t index, Arg&& arg, Args&&... args) {
+        FieldType<I>* field = new (std::get<I>(columns_) + index) FieldType<I>(std::forward<Arg>(arg));
+        if constexpr (sizeof...(Args) != 0) {
+            try {
+                ConstructFields<I + 1>(index, std::forward<Args>(args)...);
+            } catch (...) {
+                std::destroy_at(field);
+                throw;
+            }
+        }
+    }
+
+    void DestroyRows(size_t first, size_t count) noexcept {
+        std::apply(
+            [first, count](RawMemory<Fields>&... columns) {
+                (std::destroy_n(columns + first, count), ...);
+            },
+            columns_);
+    }
+
+private:
+    Columns columns_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
+
+// Вектор записей с удвоением вместимости. Другую стратегию роста задаёт BasicSoAVector
+template <typename... Fields>
+using SoAVector = BasicSoAVector<DoublingGrowth, Fields...>;
@@ -0,0 +1,369 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Хранилище StaticVector. Тривиальные типы лежат в обычном массиве. В константных выражениях
+// все элементы массива должны быть инициализированы, поэтому при ZeroInit он заполняется нулями
+// при каждом создании вектора. Без ZeroInit массив не инициализируется
+template <typename T, size_t N, bool ZeroInit, bool = std::is_trivial_v<T>>
+struct StaticVectorStorage;
+
+template <typename T, size_t N>
+struct StaticVectorStorage<T, N, true, true> {
+    constexpr T* Data() noexcept {
+        return elems;
+    }
+    constexpr const T* Data() const noexcept {
+        return elems;
+    }
+
+    T elems[N] = {};
+    size_t size = 0;
+};
+
+template <typename T, size_t N>
+struct StaticVectorStorage<T, N, false, true> {
+    T* Data() noexcept {
+        return elems;
+    }
+    const T* Data() const noexcept {
+        return elems;
+    }
+
+    T elems[N];
+    size_t size = 0;
+};
+
+template <typename T, size_t N>
+struct StaticVectorStorage<T, N, false, false> {
+    StaticVectorStorage() = default;
+    StaticVectorStorage(const StaticVectorStorage&) = delete;
+    StaticVectorStorage& operator=(const StaticVectorStorage&) = delete;
+
+    ~StaticVectorStorage() {
+        std::destroy_n(Data(), size);
+    }
+
+    T* Data() noexcept {
+        return std::launder(reinterpret_cast<T*>(bytes));
+    }
+    const T* Data() const noexcept {
+        return const_cast<StaticVectorStorage&>(*this).Data();
+    }
+
+    alignas(T) std::byte bytes[N * sizeof(T)];
+    size_t size = 0;
+};
+
+// Вектор с вместимостью N внутри объекта, никогда не обращающийся к куче.
+// Добавление в заполненный вектор выбрасывает std::length_error, вектор при этом не меняется.
+// Остальные операции ведут себя как у Vector со свободным местом: Resize и EmplaceBack дают строгую
+// гарантию безопасности исключений, вставка в середину и присваивание — базовую.
+// Перемещение переносит элементы по одному и оставляет источник пустым.
+// При Constexpr (только для тривиальных T) все операции доступны в constexpr-функциях, что позволяет
+// строить таблицы во время компиляции. Цена — заполнение нулями всех N элементов при создании вектора
+// и поэлементные сдвиги вместо memmove, поэтому во время выполнения лучше вариант по умолчанию
+template <typename T, size_t N, bool Constexpr = false>
+class StaticVector {
+    static_assert(N > 0, "StaticVector needs non-zero capacity");
+    static_assert(!Constexpr || std::is_trivial_v<T>, "Only trivial types can be used in constant expressions");
+
+    static constexpr bool IS_TRIVIAL = std::is_trivial_v<T>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t CAPACITY = N;
+
+    constexpr iterator begin() noexcept {
+        return Data();
+    }
+    constexpr iterator end() noexcept {
+        return Data() + storage_.size;
+    }
+    constexpr const_iterator begin() const noexcept {
+        return Data();
+    }
+    constexpr const_iterator end() const noexcept {
+        return Data() + storage_.size;
+    }
+    constexpr const_iterator cbegin() const noexcept {
+        return Data();
+    }
+    constexpr const_iterator cend() const noexcept {
+        return Data() + storage_.size;
+    }
+
+public:
+    StaticVector() = default;
+
+    constexpr explicit StaticVector(size_t count) {
+        Resize(count);
+    }
+    constexpr StaticVector(std::initializer_list<T> init) {
+        CheckCapacity(init.size());
+        CopyN(init.begin(), init.size(), Data());
+        storage_.size = init.size();
+    }
+
+    constexpr StaticVector(const StaticVector& other) {
+        CopyN(other.Data(), other.storage_.size, Data());
+        storage_.size = other.storage_.size;
+    }
+    // Как и у SmallVector, элементы перемещаются по одному, а источник становится пустым
+    constexpr StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        MoveN(other.Data(), other.storage_.size, Data());
+        storage_.size = other.storage_.size;
+        other.Clear();
+    }
+
+    constexpr StaticVector& operator=(const StaticVector& rhs) {
+        if (this != &rhs) {
+            AssignFrom(rhs.Data(), rhs.storage_.size, [](const T& value) -> const T& {
+                return value;
+            });
+        }
+        return *this;
+    }
+    constexpr StaticVector& operator=(StaticVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            AssignFrom(rhs.Data(), rhs.storage_.size, [](T& value) -> T&& {
+                return std::move(value);
+            });
+            rhs.Clear();
+        }
+        return *this;
+    }
+
+    // Элементы хранятся внутри объектов, поэтому обмен, в отличие от Vector, поэлементный:
+    // он занимает линейное время и даёт базовую гарантию, если перемещение T выбрасывает исключение
+    constexpr void Swap(StaticVector& other) noexcept(std::is_nothrow_move_constructible_v<T>
+                                                      && std::is_nothrow_swappable_v<T>) {
+        StaticVector& shorter = storage_.size <= other.storage_.size ? *this : other;
+        StaticVector& longer = &shorter == this ? other : *this;
+        const size_t common = shorter.storage_.size;
+        for (size_t i = 0; i < common; ++i) {
+            SwapElements(Data()[i], other.Data()[i]);
+        }
+        const size_t rest = longer.storage_.size - common;
+        MoveN(longer.Data() + common, rest, shorter.Data() + common);
+        shorter.storage_.size += rest;
+        DestroyN(longer.Data() + common, rest);
+        longer.storage_.size = common;
+    }
+
+    constexpr size_t Size() const noexcept {
+        return storage_.size;
+    }
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+    // Вместимость постоянна, поэтому Reserve только проверяет, что new_capacity не больше N
+    static constexpr void Reserve(size_t new_capacity) {
+        CheckCapacity(new_capacity);
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        assert(index < storage_.size);
+        return Data()[index];
+    }
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < storage_.size);
+        return Data()[index];
+    }
+
+    constexpr void Resize(size_t new_size) {
+        CheckCapacity(new_size);
+        if (new_size < storage_.size) {
+            DestroyN(Data() + new_size, storage_.size - new_size);
+        } else {
+            ValueConstructN(Data() + storage_.size, new_size - storage_.size);
+        }
+        storage_.size = new_size;
+    }
+    constexpr void Resize(size_t new_size, const T& value) {
+        CheckCapacity(new_size);
+        if (new_size < storage_.size) {
+            DestroyN(Data() + new_size, storage_.size - new_size);
+        } else {
+            FillN(Data() + storage_.size, new_size - storage_.size, value);
+        }
+        storage_.size = new_size;
+    }
+    constexpr void Clear() noexcept {
+        DestroyN(Data(), storage_.size);
+        storage_.size = 0;
+    }
+
+    constexpr void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    constexpr void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        CheckCapacity(storage_.size + 1);
+        ConstructAt(Data() + storage_.size, std::forward<Args>(args)...);
+        ++storage_.size;
+        return Data()[storage_.size - 1];
+    }
+    constexpr void PopBack() noexcept {
+        if (storage_.size != 0) {
+            --storage_.size;
+            DestroyN(Data() + storage_.size, 1);
+        }
+    }
+
+    // Сдвиг хвоста выполняется как в Vector, поэтому аргументы могут ссылаться на элементы вектора
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t delta = pos - cbegin();
+        CheckCapacity(storage_.size + 1);
+        if constexpr (!Constexpr) {
+            EmplaceShifted(Data() + delta, end(), std::forward<Args>(args)...);
+        } else if (delta == storage_.size) {
+            ConstructAt(end(), std::forward<Args>(args)...);
+        } else {
+            T tmp(std::forward<Args>(args)...);
+            ConstructAt(end(), std::move(Data()[storage_.size - 1]));
+            for (size_t i = storage_.size - 1; i > delta; --i) {
+                Data()[i] = std::move(Data()[i - 1]);
+            }
+            Data()[delta] = std::move(tmp);
+        }
+        ++storage_.size;
+        return begin() + delta;
+    }
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    constexpr iterator Erase(const_iterator pos) noexcept {
+        return Erase(pos, pos + 1);
+    }
+    constexpr iterator Erase(const_iterator first, const_iterator last) noexcept {
+        const size_t delta = first - cbegin();
+        const size_t count = last - first;
+        if constexpr (Constexpr) {
+            for (size_t i = delta; i + count < storage_.size; ++i) {
+                Data()[i] = std::move(Data()[i + count]);
+            }
+        } else {
+            EraseN(Data() + delta, end(), count);
+        }
+        storage_.size -= count;
+        return begin() + delta;
+    }
+
+private:
+    static constexpr void CheckCapacity(size_t new_size) {
+        if (new_size > N) {
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+    }
+
+    // Для тривиальных типов элементы создаются присваиванием, допустимым в константных выражениях.
+    // Для остальных используются алгоритмы, удаляющие созданные элементы при исключении
+
+    template <typename... Args>
+    static constexpr void ConstructAt(T* place, Args&&... args) {
+        if constexpr (IS_TRIVIAL) {
+            *place = T(std::forward<Args>(args)...);
+        } else {
+            new (place) T(std::forward<Args>(args)...);
+        }
+    }
+    static constexpr void ValueConstructN(T* dest, size_t n) {
+        if constexpr (IS_TRIVIAL) {
+            for (size_t i = 0; i < n; ++i) {
+                dest[i] = T();
+            }
+        } else {
+            std::uninitialized_value_construct_n(dest, n);
+        }
+    }
+    static constexpr void FillN(T* dest, size_t n, const T& value) {
+        if constexpr (IS_TRIVIAL) {
+            for (size_t i = 0; i < n; ++i) {
+                dest[i] = value;
+            }
+        } else {
+            std::uninitialized_fill_n(dest, n, value);
+        }
+    }
+    static constexpr void CopyN(const T* from, size_t n, T* to) {
+        if constexpr (IS_TRIVIAL) {
+            for (size_t i = 0; i < n; ++i) {
+                to[i] = from[i];
+            }
+        } else {
+            std::uninitialized_copy_n(from, n, to);
+        }
+    }
+    static constexpr void MoveN(T* from, size_t n, T* to) {
+        if constexpr (IS_TRIVIAL) {
+            CopyN(from, n, to);
+        } else {
+            std::uninitialized_move_n(from, n, to);
+        }
+    }
+    static constexpr void DestroyN(T* buf, size_t n) noexcept {
+        if constexpr (!IS_TRIVIAL) {
+            std::destroy_n(buf, n);
+        }
+    }
+    static constexpr void SwapElements(T& lhs, T& rhs) noexcept(std::is_nothrow_swappable_v<T>) {
+        if constexpr (IS_TRIVIAL) {
+            T tmp = lhs;
+            lhs = rhs;
+            rhs = tmp;
+        } else {
+            using std::swap;
+            swap(lhs, rhs);
+        }
+    }
+
+    // Присваивает существующим элементам и создаёт или удаляет остальные. get выбирает копирование или перемещение
+    template <typename Source, typename Get>
+    constexpr void AssignFrom(Source* from, size_t n, Get get) {
+        const size_t common = n < storage_.size ? n : storage_.size;
+        for (size_t i = 0; i < common; ++i) {
+            Data()[i] = get(from[i]);
+        }
+        if (n < storage_.size) {
+            DestroyN(Data() + n, storage_.size - n);
+        } else if constexpr (std::is_const_v<Source>) {
+            CopyN(from + storage_.size, n - storage_.size, Data() + storage_.size);
+        } else {
+            MoveN(from + storage_.size, n - storage_.size, Data() + storage_.size);
+        }
+        storage_.size = n;
+    }
+
+    constexpr T* Data() noexcept {
+        return storage_.Data();
+    }
+    constexpr const T* Data() const noexcept {
+        return storage_.Data();
+    }
+
+private:
+    StaticVectorStorage<T, N, Constexpr> storage_;
+};
+
+// StaticVector, который можно создавать и изменять в константных выражениях
+template <typename T, size_t N>
+using ConstexprStaticVector = StaticVector<T, N, true>;
@@ -1,83 +1,577 @@
 #pragma once
+#include "vector_simd.h"
+
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <new>
+#include <type_traits>
 #include <utility>
 #include <memory>
 #include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <cstddef>
+#include <limits>
+#include <exception>
+#include <thread>
 
 #include <iostream>
 
+// При поддержке выделения памяти в константных выражениях (C++20) RawMemory и основные операции
+// Vector объявляются constexpr: вектор можно создать, изменить и уничтожить во время компиляции.
+// Ветви с memcpy, memmove, realloc и SIMD-ядрами в константных вычислениях заменяются поэлементными.
+// В C++17 макрос пуст и код не меняется
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc)
+#define VECTOR_CONSTEXPR constexpr
+#define VECTOR_CONSTEXPR_ALLOC 1
+#else
+#define VECTOR_CONSTEXPR
+#define VECTOR_CONSTEXPR_ALLOC 0
+#endif
+
+// Объекты типа можно переносить в другую область памяти побайтовым копированием,
+// не вызывая конструктор перемещения для копии и деструктор для оригинала.
+// Для типов, которые не являются тривиально копируемыми, но допускают такой перенос
+// (например, владеющие указателем), можно явно специализировать шаблон.
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool IS_TRIVIALLY_RELOCATABLE = IsTriviallyRelocatable<T>::value;
+
+namespace vector_detail {
+
+// Выполняется ли код в константном вычислении. До C++20 всегда false
+constexpr bool IsConstantEvaluated() noexcept {
+#if VECTOR_CONSTEXPR_ALLOC
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+// Аналоги placement new и std::uninitialized_*, допустимые в константных вычислениях.
+// Во время выполнения вызывают стандартные алгоритмы, а в константных вычислениях создают
+// элементы по одному через std::construct_at: исключение там невозможно, откат не нужен
+template <typename T, typename... Args>
+VECTOR_CONSTEXPR T* ConstructAt(T* place, Args&&... args) {
+#if VECTOR_CONSTEXPR_ALLOC
+    return std::construct_at(place, std::forward<Args>(args)...);
+#else
+    return new (place) T(std::forward<Args>(args)...);
+#endif
+}
+
+template <typename T>
+VECTOR_CONSTEXPR void UninitializedValueConstructN(T* dest, size_t n) {
+    if (IsConstantEvaluated()) {
+        for (size_t i = 0; i < n; ++i) {
+            ConstructAt(dest + i);
+        }
+    } else {
+        std::uninitialized_value_construct_n(dest, n);
+    }
+}
+
+template <typename T>
+VECTOR_CONSTEXPR void UninitializedFillN(T* dest, size_t n, const T& value) {
+    if (IsConstantEvaluated()) {
+        for (size_t i = 0; i < n; ++i) {
+            ConstructAt(dest + i, value);
+        }
+    } else {
+        std::uninitialized_fill_n(dest, n, value);
+    }
+}
+
+template <typename InputIt, typename T>
+VECTOR_CONSTEXPR void UninitializedCopyN(InputIt from, size_t n, T* to) {
+    if (IsConstantEvaluated()) {
+        for (size_t i = 0; i < n; ++i, ++from) {
+            ConstructAt(to + i, *from);
+        }
+    } else {
+        std::uninitialized_copy_n(from, n, to);
+    }
+}
+
+template <typename T>
+VECTOR_CONSTEXPR void UninitializedMoveN(T* from, size_t n, T* to) {
+    if (IsConstantEvaluated()) {
+        for (size_t i = 0; i < n; ++i) {
+            ConstructAt(to + i, std::move(from[i]));
+        }
+    } else {
+        std::uninitialized_move_n(from, n, to);
+    }
+}
+
+// Перемещает элементы, если перемещение не бросает исключений или копирование невозможно, иначе копирует
+template <typename T>
+VECTOR_CONSTEXPR void UninitializedTransferN(T* from, size_t n, T* to) {
+    if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+        UninitializedMoveN(from, n, to);
+    } else {
+        UninitializedCopyN(from, n, to);
+    }
+}
+
+}  // namespace vector_detail
+
+// Переносит n элементов из from в неинициализированную память to, уничтожая оригиналы.
+// Если перенос прерван исключением, исходные элементы остаются нетронутыми
+template <typename T>
+VECTOR_CONSTEXPR void UninitializedRelocateN(T* from, size_t n, T* to) {
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        if (!vector_detail::IsConstantEvaluated()) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+            }
+            return;
+        }
+    }
+    vector_detail::UninitializedTransferN(from, n, to);
+    std::destroy_n(from, n);
+}
+
+// Элемент можно создать прямо на месте вставки pos, сдвинув хвост [pos, end) побайтово,
+// если тип тривиально перемещаем и ни один аргумент не находится в сдвигаемой части.
+// Иначе вставка создаёт временный объект до сдвига.
+// Указатели на элементы хвоста, переданные как аргументы, не распознаются
+template <typename T, typename... Args>
+VECTOR_CONSTEXPR bool CanEmplaceIntoGap(const T* pos, const T* end, const Args&... args) noexcept {
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        if (vector_detail::IsConstantEvaluated()) {
+            return false;
+        }
+        const auto* first = reinterpret_cast<const std::byte*>(pos);
+        const auto* last = reinterpret_cast<const std::byte*>(end);
+        const auto in_tail = [first, last](const void* arg) {
+            const auto* p = static_cast<const std::byte*>(arg);
+            return !std::less<const std::byte*>()(p, first) && std::less<const std::byte*>()(p, last);
+        };
+        return !(in_tail(std::addressof(args)) || ...);
+    } else {
+        return false;
+    }
+}
+
+// Сдвигает хвост [pos, end) на один элемент побайтово и создаёт элемент на месте pos.
+// Буфер должен вмещать ещё один элемент. Если конструктор выбросит исключение, хвост возвращается на место
+template <typename T, typename... Args>
+void EmplaceIntoGap(T* pos, T* end, Args&&... args) {
+    const size_t tail_bytes = (end - pos) * sizeof(T);
+    std::memmove(static_cast<void*>(pos + 1), static_cast<const void*>(pos), tail_bytes);
+    try {
+        new (pos) T(std::forward<Args>(args)...);
+    } catch (...) {
+        std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + 1), tail_bytes);
+        throw;
+    }
+}
+
+// Создаёт элемент на месте pos, сдвигая хвост [pos, end) на один элемент вправо.
+// Буфер должен вмещать ещё один элемент. Аргументы могут ссылаться на элементы буфера:
+// если элемент нельзя создать прямо на месте, он создаётся во временном объекте до сдвига
+template <typename T, typename... Args>
+VECTOR_CONSTEXPR void EmplaceShifted(T* pos, T* end, Args&&... args) {
+    if (pos == end) {
+        vector_detail::ConstructAt(end, std::forward<Args>(args)...);
+    } else if (CanEmplaceIntoGap(pos, end, args...)) {
+        EmplaceIntoGap(pos, end, std::forward<Args>(args)...);
+    } else {
+        T tmp(std::forward<Args>(args)...);
+        vector_detail::ConstructAt(end, std::move(*(end - 1)));
+        std::move_backward(pos, end - 1, end);
+        *pos = std::move(tmp);
+    }
+}
+
+// Переносит size элементов из from в неинициализированную память to, оставляя на позиции delta
+// count элементов, уже созданных в to. При исключении эти элементы уничтожаются, а оригиналы не меняются
+template <typename T>
+VECTOR_CONSTEXPR void UninitializedRelocateAroundGap(T* from, size_t size, size_t delta, size_t count, T* to) {
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        UninitializedRelocateN(from, delta, to);
+        UninitializedRelocateN(from + delta, size - delta, to + delta + count);
+    } else {
+        try {
+            vector_detail::UninitializedTransferN(from, delta, to);
+        } catch (...) {
+            std::destroy_n(to + delta, count);
+            throw;
+        }
+        try {
+            vector_detail::UninitializedTransferN(from + delta, size - delta, to + delta + count);
+        } catch (...) {
+            std::destroy_n(to, delta + count);
+            throw;
+        }
+        std::destroy_n(from, size);
+    }
+}
+
+// Удаляет count элементов, начиная с pos, сдвигая хвост до end влево
+template <typename T>
+VECTOR_CONSTEXPR void EraseN(T* pos, T* end, size_t count) noexcept {
+    if (count == 0) {
+        return;
+    }
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (!vector_detail::IsConstantEvaluated()) {
+            std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count),
+                         (end - pos - count) * sizeof(T));
+            return;
+        }
+    }
+    std::move(pos + count, end, pos);
+    std::destroy_n(end - count, count);
+}
+
+// Тег конструктора, инициализирующего элементы по умолчанию вместо инициализации значением
+struct DefaultInitTag {};
+inline constexpr DefaultInitTag DEFAULT_INIT{};
+
+// Политика параллельного конструирования и уничтожения элементов.
+// Элементы делятся на части не меньше min_chunk, каждая часть обрабатывается в своём потоке
+struct ParallelTag {
+    // Наибольшее число потоков, 0 — std::thread::hardware_concurrency()
+    unsigned threads = 0;
+    size_t min_chunk = size_t{1} << 16;
+};
+inline constexpr ParallelTag PARALLEL{};
+
+template <typename It>
+using RequireInputIterator = std::enable_if_t<
+    std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>>;
+
+template <typename It>
+inline constexpr bool IS_FORWARD_ITERATOR =
+    std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+// Аллокатор поддерживает изменение размера уже выделенного блока:
+// T* reallocate(T* p, size_t old_n, size_t new_n).
+// Блок может быть расширен на месте либо перенесён побайтово
+template <typename Allocator, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Allocator>
+struct HasReallocate<Allocator,
+                     std::void_t<decltype(std::declval<Allocator&>().reallocate(
+                         std::declval<typename std::allocator_traits<Allocator>::value_type*>(), size_t{}, size_t{}))>>
+    : std::true_type {};
+
+// Аллокатор поверх malloc/realloc/free. Позволяет расширять буфер на месте,
+// а для больших блоков glibc выполняет realloc через mremap без копирования данных
 template <typename T>
-class RawMemory {
+struct MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc can't allocate over-aligned types");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    MallocAllocator() = default;
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {  // NOLINT
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(CheckAllocated(std::malloc(CheckedSize(n))));
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        std::free(p);
+    }
+
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) {
+        return static_cast<T*>(CheckAllocated(std::realloc(static_cast<void*>(p), CheckedSize(new_n))));
+    }
+
+    bool operator==(const MallocAllocator& /*other*/) const noexcept {
+        return true;
+    }
+    bool operator!=(const MallocAllocator& /*other*/) const noexcept {
+        return false;
+    }
+
+private:
+    static size_t CheckedSize(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static void* CheckAllocated(void* p) {
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+};
+
+
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Аллокатор, выравнивающий буфер по границе Alignment байт (по умолчанию по кеш-линии),
+// чтобы векторные загрузки не пересекали границы кеш-линий.
+// std::allocator выравнивает буфер лишь по alignof(T)
+template <typename T, size_t Alignment = CACHE_LINE_SIZE>
+struct AlignedAllocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment is weaker than alignof(T)");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t ALIGNMENT = Alignment;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, std::max(Alignment, alignof(U))>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U, size_t OtherAlignment>
+    AlignedAllocator(const AlignedAllocator<U, OtherAlignment>& /*other*/) noexcept {  // NOLINT
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ::operator delete(p, n * sizeof(T), std::align_val_t{Alignment});
+    }
+
+    bool operator==(const AlignedAllocator& /*other*/) const noexcept {
+        return true;
+    }
+    bool operator!=(const AlignedAllocator& /*other*/) const noexcept {
+        return false;
+    }
+};
+
+// Стратегии роста определяют новую вместимость заполненного вектора:
+// static size_t NextCapacity(size_t capacity, size_t element_size).
+// Результат должен быть больше capacity. Для константных вычислений метод должен быть constexpr
+
+// Удвоение вместимости: 1, 2, 4, 8...
+struct DoublingGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t /*element_size*/) noexcept {
+        return capacity == 0 ? 1 : capacity * 2;
+    }
+};
+
+// Рост в Numerator / Denominator раз, по умолчанию в 1.5 раза
+template <size_t Numerator = 3, size_t Denominator = 2>
+struct GeometricGrowth {
+    static_assert(Numerator > Denominator && Denominator > 0);
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t /*element_size*/) noexcept {
+        return capacity + std::max<size_t>(1, capacity / Denominator * (Numerator - Denominator));
+    }
+};
+
+// Первое выделение сразу под MinCapacity элементов, дальше рост по стратегии Base
+template <size_t MinCapacity, typename Base = DoublingGrowth>
+struct MinCapacityGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t element_size) noexcept {
+        return std::max(MinCapacity, Base::NextCapacity(capacity, element_size));
+    }
+};
+
+// Первое выделение занимает как минимум одну кеш-линию
+template <typename Base = DoublingGrowth>
+struct CacheLineGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t element_size) noexcept {
+        return std::max(CACHE_LINE_SIZE / element_size, Base::NextCapacity(capacity, element_size));
+    }
+};
+
+// Вместимость округляется вверх так, чтобы буфер занимал целое число кеш-линий.
+// Вместе с AlignedAllocator хвост буфера не делит кеш-линию с чужими данными
+template <typename Base = DoublingGrowth>
+struct CacheLinePaddedGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t element_size) noexcept {
+        const size_t bytes = Base::NextCapacity(capacity, element_size) * element_size;
+        const size_t padded = (bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+        return std::max(capacity + 1, padded / element_size);
+    }
+};
+
+// Размер блока округляется вверх до типичного класса размеров аллокатора:
+// степени двойки до страницы и целого числа страниц после неё, чтобы не терять хвост блока
+template <typename Base = DoublingGrowth, size_t PageSize = 4096>
+struct SizeClassGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t element_size) noexcept {
+        const size_t bytes = Base::NextCapacity(capacity, element_size) * element_size;
+        size_t rounded = bytes;
+        if (bytes <= PageSize) {
+            rounded = 1;
+            while (rounded < bytes) {
+                rounded *= 2;
+            }
+        } else if (bytes % PageSize != 0) {
+            rounded = bytes + (PageSize - bytes % PageSize);
+        }
+        return std::max(capacity + 1, rounded / element_size);
+    }
+};
+
+// Рост по стратегии Base, пока буфер меньше ThresholdBytes, а затем линейный
+// на ThresholdBytes за раз, что ограничивает неиспользуемую память у больших векторов
+template <size_t ThresholdBytes, typename Base = DoublingGrowth>
+struct LinearGrowthAfter {
+    static constexpr size_t NextCapacity(size_t capacity, size_t element_size) noexcept {
+        if (capacity * element_size < ThresholdBytes) {
+            return Base::NextCapacity(capacity, element_size);
+        }
+        return capacity + std::max<size_t>(1, ThresholdBytes / element_size);
+    }
+};
+
+// Статистика работы вектора с памятью. Собирается только при определённом макросе
+// ADVANCED_VECTOR_STATS, иначе учёт не компилируется и не влияет на размер Vector
+struct VectorStats {
+    // Метка места создания вектора, задаётся через SetStatsLabel
+    const char* label = nullptr;
+    size_t allocations = 0;
+    size_t bytes_allocated = 0;
+    // Замены существующего буфера новым при Reserve, Emplace, Insert и ShrinkToFit
+    size_t reallocations = 0;
+    // Элементы, перенесённые в новый буфер конструктором перемещения, копирования или побайтово
+    size_t elements_moved = 0;
+    size_t elements_copied = 0;
+    size_t elements_relocated = 0;
+    size_t peak_capacity = 0;
+};
+
+using VectorStatsHandler = void (*)(const VectorStats& stats);
+
+// Обработчик, получающий статистику каждого вектора при его уничтожении
+inline VectorStatsHandler& GetVectorStatsHandler() noexcept {
+    static VectorStatsHandler handler = nullptr;
+    return handler;
+}
+
+inline void SetVectorStatsHandler(VectorStatsHandler handler) noexcept {
+    GetVectorStatsHandler() = handler;
+}
+
+// Сырая память под capacity элементов типа T, выделяемая через Allocator.
+// Пустой аллокатор (например, std::allocator) не увеличивает размер объекта
+// благодаря оптимизации пустого базового класса.
+// Перемещение и обмен затрагивают только буфер: аллокаторы обоих объектов должны быть равны,
+// распространение аллокаторов выполняет Vector
+template <typename T, typename Allocator = std::allocator<T>>
+class RawMemory : private Allocator {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>, "Allocator::value_type must be T");
+
 public:
+    using allocator_type = Allocator;
+
     RawMemory() = default;
 
-    explicit RawMemory(size_t capacity)
-    : buffer_(Allocate(capacity))
+    VECTOR_CONSTEXPR explicit RawMemory(const Allocator& alloc) noexcept
+    : Allocator(alloc) {
+    }
+
+    VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const Allocator& alloc = Allocator())
+    : Allocator(alloc)
+    , buffer_(Allocate(capacity))
     , capacity_(capacity) {
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
-    RawMemory(RawMemory&& other) noexcept {
+    VECTOR_CONSTEXPR RawMemory(RawMemory&& other) noexcept
+    : Allocator(std::move(other.GetAllocator())) {
         buffer_ = std::exchange(other.buffer_, nullptr);
         capacity_ = std::exchange(other.capacity_, 0);
     }
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
+    VECTOR_CONSTEXPR RawMemory& operator=(RawMemory&& rhs) noexcept {
         Deallocate(buffer_);
         buffer_ = std::exchange(rhs.buffer_, nullptr);
         capacity_ = std::exchange(rhs.capacity_, 0);
         return *this;
     }
 
-    ~RawMemory() {
+    VECTOR_CONSTEXPR ~RawMemory() {
         Deallocate(buffer_);
     }
 
-    T* operator+(size_t offset) noexcept {
+    VECTOR_CONSTEXPR T* operator+(size_t offset) noexcept {
         // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
         assert(offset <= capacity_);
         return buffer_ + offset;
     }
 
-    const T* operator+(size_t offset) const noexcept {
+    VECTOR_CONSTEXPR const T* operator+(size_t offset) const noexcept {
         return const_cast<RawMemory&>(*this) + offset;
     }
 
-    const T& operator[](size_t index) const noexcept {
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<RawMemory&>(*this)[index];
     }
 
-    T& operator[](size_t index) noexcept {
+    VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         assert(index < capacity_);
         return buffer_[index];
     }
 
-    void Swap(RawMemory& other) noexcept {
+    VECTOR_CONSTEXPR void Swap(RawMemory& other) noexcept {
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
     }
 
-    const T* GetAddress() const noexcept {
+    VECTOR_CONSTEXPR const T* GetAddress() const noexcept {
         return buffer_;
     }
 
-    T* GetAddress() noexcept {
+    VECTOR_CONSTEXPR T* GetAddress() noexcept {
         return buffer_;
     }
 
-    size_t Capacity() const {
+    VECTOR_CONSTEXPR size_t Capacity() const {
         return capacity_;
     }
 
+    VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return *this;
+    }
+
+    VECTOR_CONSTEXPR Allocator& GetAllocator() noexcept {
+        return *this;
+    }
+
+    // Изменяет размер буфера средствами аллокатора, перенося содержимое побайтово.
+    // Применимо только к тривиально перемещаемым элементам. При исключении буфер не меняется
+    void Reallocate(size_t new_capacity) {
+        static_assert(HasReallocate<Allocator>::value, "Allocator doesn't support reallocate");
+        if (buffer_ == nullptr) {
+            buffer_ = Allocate(new_capacity);
+        } else {
+            buffer_ = GetAllocator().reallocate(buffer_, capacity_, new_capacity);
+        }
+        capacity_ = new_capacity;
+    }
+
 private:
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    VECTOR_CONSTEXPR T* Allocate(size_t n) {
+        return n != 0 ? AllocTraits::allocate(GetAllocator(), n) : nullptr;
     }
 
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    VECTOR_CONSTEXPR void Deallocate(T* buf) noexcept {
+        if (buf != nullptr) {
+            AllocTraits::deallocate(GetAllocator(), buf, capacity_);
+        }
     }
 
 private:
@@ -85,59 +579,126 @@ private:
     size_t capacity_ = 0;
 };
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
 class Vector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
     using iterator = T*;
     using const_iterator = const T*;
+    using allocator_type = Allocator;
 
-    iterator begin() noexcept {
+    VECTOR_CONSTEXPR iterator begin() noexcept {
         return data_.GetAddress();
     }
-    iterator end() noexcept {
+    VECTOR_CONSTEXPR iterator end() noexcept {
         return data_ + size_;
     }
-    const_iterator begin() const noexcept {
+    VECTOR_CONSTEXPR const_iterator begin() const noexcept {
         return data_.GetAddress();
     }
-    const_iterator end() const noexcept {
+    VECTOR_CONSTEXPR const_iterator end() const noexcept {
         return data_ + size_;
     }
-    const_iterator cbegin() const noexcept {
+    VECTOR_CONSTEXPR const_iterator cbegin() const noexcept {
         return data_.GetAddress();
     }
-    const_iterator cend() const noexcept {
+    VECTOR_CONSTEXPR const_iterator cend() const noexcept {
         return data_ + size_;
     }
 
 public:
     Vector() = default;
 
-    explicit Vector(size_t size)
-    : data_(size)
+    VECTOR_CONSTEXPR explicit Vector(const Allocator& alloc) noexcept
+    : data_(alloc) {
+    }
+
+    VECTOR_CONSTEXPR explicit Vector(size_t size, const Allocator& alloc = Allocator())
+    : data_(size, alloc)
+    , size_(size)  //
+    {
+        vector_detail::UninitializedValueConstructN(data_.GetAddress(), size);
+        RecordAllocation(size);
+    }
+    Vector(size_t size, DefaultInitTag, const Allocator& alloc = Allocator())
+    : data_(size, alloc)
     , size_(size)  //
     {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+        std::uninitialized_default_construct_n(data_.GetAddress(), size);
+        RecordAllocation(size);
+    }
+    // Элементы конструируются параллельно. При исключении уже созданные элементы уничтожаются.
+    // Конструктор T по умолчанию должен допускать одновременный вызов из нескольких потоков
+    Vector(size_t size, ParallelTag policy, const Allocator& alloc = Allocator())
+    : data_(size, alloc)
+    , size_(size)  //
+    {
+        ParallelConstructN(data_.GetAddress(), size, policy, [](T* buf, size_t n) {
+            std::uninitialized_value_construct_n(buf, n);
+        });
+        RecordAllocation(size);
+    }
+    VECTOR_CONSTEXPR Vector(std::initializer_list<T> init, const Allocator& alloc = Allocator())
+    : data_(init.size(), alloc)
+    , size_(init.size())  //
+    {
+        vector_detail::UninitializedCopyN(init.begin(), init.size(), data_.GetAddress());
+        RecordAllocation(init.size());
+    }
+    VECTOR_CONSTEXPR Vector(const Vector& other)
+    : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))  //
+    {
     }
-    Vector(const Vector& other)
-    : data_(other.size_)
+    VECTOR_CONSTEXPR Vector(const Vector& other, const Allocator& alloc)
+    : data_(other.size_, alloc)
     , size_(other.size_)  //
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
+        CopyElements(other, data_.GetAddress());
+        RecordAllocation(other.size_);
     }
-    Vector(Vector&& other) noexcept
-    : data_(other.size_)
+    Vector(const Vector& other, ParallelTag policy)
+    : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator()))
     , size_(other.size_)  //
     {
-        data_ = std::move(other.data_);
-        size_ = std::exchange(other.size_, 0);
+        const T* from = other.data_.GetAddress();
+        ParallelConstructN(data_.GetAddress(), size_, policy, [from, to = data_.GetAddress()](T* buf, size_t n) {
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                CopyTrivially(from + (buf - to), n, buf);
+            } else {
+                std::uninitialized_copy_n(from + (buf - to), n, buf);
+            }
+        });
+        RecordAllocation(other.size_);
+    }
+    VECTOR_CONSTEXPR Vector(Vector&& other) noexcept
+    : data_(std::move(other.data_))
+    , size_(std::exchange(other.size_, 0))  //
+    {
+#ifdef ADVANCED_VECTOR_STATS
+        stats_ = std::exchange(other.stats_, VectorStats{});
+#endif
     }
 
-    Vector& operator=(const Vector& rhs) {
+    VECTOR_CONSTEXPR Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (!AllocTraits::is_always_equal::value && GetAllocator() != rhs.GetAllocator()) {
+                    // Память, выделенную текущим аллокатором, нельзя переиспользовать под новый
+                    ReplaceStorage(rhs.size_, rhs.GetAllocator(), [&rhs](T* buf) {
+                        CopyElements(rhs, buf);
+                    });
+                    return *this;
+                }
+                data_.GetAllocator() = rhs.GetAllocator();
+            }
             if (rhs.size_ > data_.Capacity()) {
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
+                ReplaceStorage(rhs.size_, GetAllocator(), [&rhs](T* buf) {
+                    CopyElements(rhs, buf);
+                });
+            } else if constexpr (std::is_trivially_copyable_v<T>) {
+                CopyTrivially(rhs.data_.GetAddress(), rhs.size_, data_.GetAddress());
+                size_ = rhs.size_;
             } else {
                 if (rhs.size_ < size_) {
                     for (size_t i = 0; i < rhs.size_; ++i) {
@@ -149,82 +710,197 @@ public:
                     for (size_t i = 0; i < size_; ++i) {
                         data_[i] = rhs[i];
                     }
-                    std::uninitialized_copy_n(rhs.data_ + size_, rhs.size_ - size_, data_.GetAddress());
+                    vector_detail::UninitializedCopyN(rhs.data_ + size_, rhs.size_ - size_, data_ + size_);
                     size_ = rhs.size_;
                 }
             }
         }
         return *this;
     }
-    Vector& operator=(Vector&& rhs) noexcept {
-        data_ = std::move(rhs.data_);
-        size_ = std::exchange(rhs.size_, 0);
+    VECTOR_CONSTEXPR Vector& operator=(Vector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                             || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                          || AllocTraits::is_always_equal::value) {
+                AdoptStorage(rhs);
+            } else {
+                if (GetAllocator() == rhs.GetAllocator()) {
+                    AdoptStorage(rhs);
+                } else {
+                    // Буфер другого аллокатора забрать нельзя, поэтому элементы перемещаются по одному
+                    ReplaceStorage(rhs.size_, GetAllocator(), [&rhs](T* buf) {
+                        vector_detail::UninitializedMoveN(rhs.begin(), rhs.size_, buf);
+                    });
+                    rhs.Resize(0);
+                }
+            }
+        }
         return *this;
     }
 
-    void Swap(Vector& other) noexcept {
+    VECTOR_CONSTEXPR void Swap(Vector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(data_.GetAllocator(), other.data_.GetAllocator());
+        } else {
+            // Обмен векторов с неравными непередаваемыми аллокаторами не поддерживается
+            assert(AllocTraits::is_always_equal::value || GetAllocator() == other.GetAllocator());
+        }
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
     }
 
-    size_t Size() const noexcept {
+    VECTOR_CONSTEXPR Allocator GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    VECTOR_CONSTEXPR size_t Size() const noexcept {
         return size_;
     }
-    size_t Capacity() const noexcept {
+    VECTOR_CONSTEXPR size_t Capacity() const noexcept {
         return data_.Capacity();
     }
 
-    const T& operator[](size_t index) const noexcept {
+    VECTOR_CONSTEXPR const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
-    T& operator[](size_t index) noexcept {
+    VECTOR_CONSTEXPR T& operator[](size_t index) noexcept {
         assert(index < size_);
         return data_[index];
     }
 
-    void Reserve(size_t new_capacity) {
+    VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
         if (new_capacity <= data_.Capacity()) {
             return;
         }
 
-        RawMemory<T> new_data(new_capacity);
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+        RecordReallocation(new_capacity, size_);
+        if constexpr (CAN_REALLOCATE) {
+            data_.Reallocate(new_capacity);
+        } else {
+            RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+            UninitializedRelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+            data_.Swap(new_data);
+        }
+    }
+    // Уменьшает вместимость до текущего размера
+    void ShrinkToFit() {
+        if (size_ == data_.Capacity()) {
+            return;
+        }
+        if (size_ == 0) {
+            data_ = RawMemory<T, Allocator>(data_.GetAllocator());
+            return;
+        }
+        RecordReallocation(size_, size_);
+        if constexpr (CAN_REALLOCATE) {
+            data_.Reallocate(size_);
         } else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+            RawMemory<T, Allocator> new_data(size_, data_.GetAllocator());
+            UninitializedRelocateN(data_.GetAddress(), size_, new_data.GetAddress());
+            data_.Swap(new_data);
         }
-        std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
     }
-    void Resize(size_t new_size) {
+    // Удаляет все элементы, сохраняя вместимость
+    VECTOR_CONSTEXPR void Clear() noexcept {
+        DestroyN(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+    // Уничтожает элементы параллельно. Деструктор Vector уничтожает элементы в одном потоке,
+    // поэтому большие векторы стоит очищать так перед уничтожением
+    void Clear(ParallelTag policy) noexcept {
+        ParallelDestroyN(data_.GetAddress(), size_, policy);
+        size_ = 0;
+    }
+    // Удаляет все элементы и освобождает память
+    void ReleaseMemory() noexcept {
+        Clear();
+        data_ = RawMemory<T, Allocator>(data_.GetAllocator());
+    }
+    VECTOR_CONSTEXPR void Resize(size_t new_size) {
         if (new_size < size_) {
             DestroyN(data_ + new_size, size_ - new_size);
         } else if (new_size > size_) {
             Reserve(new_size);
-            std::uninitialized_value_construct_n(data_ + size_, new_size - size_);
+            vector_detail::UninitializedValueConstructN(data_ + size_, new_size - size_);
         }
 
         size_ = new_size;
     }
+    void Resize(size_t new_size, ParallelTag policy) {
+        if (new_size < size_) {
+            ParallelDestroyN(data_ + new_size, size_ - new_size, policy);
+        } else if (new_size > size_) {
+            Reserve(new_size);
+            ParallelConstructN(data_ + size_, new_size - size_, policy, [](T* buf, size_t n) {
+                std::uninitialized_value_construct_n(buf, n);
+            });
+        }
 
-    void PushBack(const T& value) {
+        size_ = new_size;
+    }
+    VECTOR_CONSTEXPR void Resize(size_t new_size, const T& value) {
+        if (new_size < size_) {
+            DestroyN(data_ + new_size, size_ - new_size);
+        } else if (new_size > data_.Capacity()) {
+            // value может ссылаться на элемент вектора, который будет перенесён в новый буфер
+            const T tmp(value);
+            Reserve(new_size);
+            UninitializedFillN(data_ + size_, new_size - size_, tmp);
+        } else {
+            UninitializedFillN(data_ + size_, new_size - size_, value);
+        }
+
+        size_ = new_size;
+    }
+    // Заменяет содержимое вектора count копиями value
+    VECTOR_CONSTEXPR void Assign(size_t count, const T& value) {
+        const T tmp(value);
+        if (count > data_.Capacity()) {
+            ReplaceStorage(count, GetAllocator(), [&tmp, count](T* buf) {
+                UninitializedFillN(buf, count, tmp);
+            });
+            return;
+        }
+        FillN(data_.GetAddress(), std::min(count, size_), tmp);
+        if (count < size_) {
+            DestroyN(data_ + count, size_ - count);
+        } else {
+            UninitializedFillN(data_ + size_, count - size_, tmp);
+        }
+        size_ = count;
+    }
+    // Как Resize, но новые элементы инициализируются по умолчанию:
+    // память под тривиальные типы не заполняется нулями
+    void ResizeDefaultInit(size_t new_size) {
+        if (new_size < size_) {
+            DestroyN(data_ + new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            Reserve(new_size);
+            std::uninitialized_default_construct_n(data_ + size_, new_size - size_);
+        }
+
+        size_ = new_size;
+    }
+
+    VECTOR_CONSTEXPR void PushBack(const T& value) {
         if (size_ == Capacity()) {
             Emplace(begin() + size_, value);
         } else {
-            new (data_ + size_) T(value);
+            vector_detail::ConstructAt(data_ + size_, value);
             ++size_;
         }
     }
-    void PushBack(T&& value) {
+    VECTOR_CONSTEXPR void PushBack(T&& value) {
         if (size_ == Capacity()) {
             Emplace(begin() + size_, std::move(value));
         } else {
-            new (data_ + size_) T(std::move(value));
+            vector_detail::ConstructAt(data_ + size_, std::move(value));
             ++size_;
         }
     }
 
-    void PopBack() noexcept {
+    VECTOR_CONSTEXPR void PopBack() noexcept {
         if (size_ != 0) {
             Destroy(data_ + (size_ - 1));
             --size_;
@@ -232,47 +908,59 @@ public:
     }
 
     template <typename... Args>
-    T& EmplaceBack(Args&&... args) {
+    VECTOR_CONSTEXPR T& EmplaceBack(Args&&... args) {
         if (size_ == Capacity()) {
             return *Emplace(begin() + size_, std::forward<Args>(args)...);
         } else {
-            new (data_ + size_) T(std::forward<Args>(args)...);
+            vector_detail::ConstructAt(data_ + size_, std::forward<Args>(args)...);
             ++size_;
             return data_[size_ - 1];
         }
     }
 
+    // Добавляет count элементов, созданных из args, выполняя не более одной реаллокации.
+    // Аргументы передаются каждому конструктору как lvalue и могут ссылаться на элементы вектора.
+    // Если конструктор выбросит исключение, удаляются только элементы этого вызова
+    template <typename... Args>
+    void EmplaceBackN(size_t count, const Args&... args) {
+        AppendN(count, [&args...](T* place, size_t /*index*/) {
+            new (place) T(args...);
+        });
+    }
+    // Добавляет count элементов, созданных из результатов generator(i) для i от 0 до count - 1
+    template <typename Generator>
+    void AppendGenerated(size_t count, Generator&& generator) {
+        AppendN(count, [&generator](T* place, size_t index) {
+            new (place) T(generator(index));
+        });
+    }
+
     template <typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... args) {
+    VECTOR_CONSTEXPR iterator Emplace(const_iterator pos, Args&&... args) {
         auto delta = pos - begin();
 
         if (size_ == Capacity()) {
-            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-            new (new_data + delta) T(std::forward<Args>(args)...);
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                TryInitMove(delta, new_data);
+            const size_t new_capacity = GrowthPolicy::NextCapacity(size_, sizeof(T));
+            assert(new_capacity > size_);
+            RecordReallocation(new_capacity, size_);
+            if constexpr (CAN_REALLOCATE) {
+                ReallocateAndEmplace(delta, new_capacity, std::forward<Args>(args)...);
             } else {
-                TryInitCopy(delta, new_data);
+                RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+                vector_detail::ConstructAt(new_data + delta, std::forward<Args>(args)...);
+                RelocateAroundGap(delta, 1, new_data);
+                data_ = std::move(new_data);
             }
-            std::destroy_n(data_.GetAddress(), size_);
-            data_ = std::move(new_data);
 
         } else {
-            if (size_ == 0) {
-                new (begin()) T(std::forward<Args>(args)...);
-            } else {
-                T tmp(std::forward<Args>(args)...);
-                new (end()) T(std::forward<T>(*(end() - 1)));
-                std::move_backward(begin() + delta, end() - 1, end());
-                data_[delta] = std::move(tmp);
-            }
+            EmplaceShifted(data_ + delta, end(), std::forward<Args>(args)...);
         }
 
         ++size_;
         return begin() + delta;
     }
 
-    iterator Erase(const_iterator pos) noexcept {
+    VECTOR_CONSTEXPR iterator Erase(const_iterator pos) noexcept {
         auto delta = pos - begin();
         for (size_t i = delta + 1; i < size_; ++i) {
             data_[i - 1] = std::move(data_[i]);
@@ -281,24 +969,217 @@ public:
         --size_;
         return begin() + delta;
     }
+    VECTOR_CONSTEXPR iterator Erase(const_iterator first, const_iterator last) noexcept {
+        const size_t delta = first - begin();
+        const size_t count = last - first;
+        EraseN(begin() + delta, end(), count);
+        size_ -= count;
+        return begin() + delta;
+    }
+
+    // Удаляет все элементы, удовлетворяющие pred, за один проход, сохраняя порядок остальных.
+    // Возвращает число удалённых элементов
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred) {
+        T* dest = std::find_if(begin(), end(), pred);
+        if (dest == end()) {
+            return 0;
+        }
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            // Уцелевшие элементы сдвигаются непрерывными блоками
+            T* it = dest + 1;
+            while (it != end()) {
+                T* run_end = std::find_if(it, end(), pred);
+                const size_t run_size = run_end - it;
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(it), run_size * sizeof(T));
+                dest += run_size;
+                it = run_end == end() ? run_end : run_end + 1;
+            }
+        } else {
+            for (T* it = dest + 1; it != end(); ++it) {
+                if (!pred(*it)) {
+                    *dest = std::move(*it);
+                    ++dest;
+                }
+            }
+            DestroyN(dest, end() - dest);
+        }
+        const size_t removed = end() - dest;
+        size_ -= removed;
+        return removed;
+    }
+
+    // Удаляет все элементы, равные value
+    size_t Remove(const T& value) {
+        // value может быть элементом вектора, который будет перезаписан при сдвиге
+        const std::less<const T*> less;
+        if (!less(&value, begin()) && less(&value, end())) {
+            const T tmp(value);
+            return EraseIf([&tmp](const T& elem) {
+                return elem == tmp;
+            });
+        }
+        return EraseIf([&value](const T& elem) {
+            return elem == value;
+        });
+    }
 
-    iterator Insert(const_iterator pos, const T& value) {
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, const T& value) {
         return Emplace(pos, value);
     }
-    iterator Insert(const_iterator pos, T&& value) {
+    VECTOR_CONSTEXPR iterator Insert(const_iterator pos, T&& value) {
         return Emplace(pos, std::move(value));
     }
+    iterator Insert(const_iterator pos, size_t count, const T& value) {
+        const size_t delta = pos - begin();
+        if (count != 0) {
+            // value может ссылаться на элемент вектора, который будет сдвинут или перенесён
+            const T tmp(value);
+            InsertN(delta, count, FillSource{tmp});
+        }
+        return begin() + delta;
+    }
+    // Диапазон не должен ссылаться на элементы самого вектора
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        const size_t delta = pos - begin();
+        if constexpr (IS_FORWARD_ITERATOR<InputIt>) {
+            InsertN(delta, static_cast<size_t>(std::distance(first, last)), RangeSource<InputIt>{first});
+        } else {
+            const size_t old_size = size_;
+            Append(first, last);
+            std::rotate(begin() + delta, begin() + old_size, end());
+        }
+        return begin() + delta;
+    }
 
-    ~Vector() {
+    template <typename InputIt, typename = RequireInputIterator<InputIt>>
+    void Append(InputIt first, InputIt last) {
+        if constexpr (IS_FORWARD_ITERATOR<InputIt>) {
+            InsertN(size_, static_cast<size_t>(std::distance(first, last)), RangeSource<InputIt>{first});
+        } else {
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        }
+    }
+
+#ifdef ADVANCED_VECTOR_STATS
+    const VectorStats& Stats() const noexcept {
+        return stats_;
+    }
+    void SetStatsLabel(const char* label) noexcept {
+        stats_.label = label;
+    }
+#endif
+
+    VECTOR_CONSTEXPR ~Vector() {
         DestroyN(data_.GetAddress(), size_);
+#ifdef ADVANCED_VECTOR_STATS
+        if (vector_detail::IsConstantEvaluated()) {
+            return;
+        }
+        if (VectorStatsHandler handler = GetVectorStatsHandler()) {
+            handler(stats_);
+        }
+#endif
     }
 
 private:
-    RawMemory<T> data_;
+    // Буфер можно расширять на месте без поэлементного переноса
+    static constexpr bool CAN_REALLOCATE = IS_TRIVIALLY_RELOCATABLE<T> && HasReallocate<Allocator>::value;
+
+    RawMemory<T, Allocator> data_;
     size_t size_ = 0;
+#ifdef ADVANCED_VECTOR_STATS
+    VectorStats stats_;
+#endif
 
 private:
-    static void DestroyN(T* buf, size_t n) noexcept {
+    static size_t ParallelChunkCount(size_t n, const ParallelTag& policy) noexcept {
+        const size_t threads = policy.threads != 0 ? policy.threads : std::thread::hardware_concurrency();
+        return std::max<size_t>(1, std::min(threads, n / std::max<size_t>(1, policy.min_chunk)));
+    }
+
+    // Начало и длина части index при делении n элементов на chunks почти равных частей
+    static std::pair<size_t, size_t> ChunkBounds(size_t index, size_t n, size_t chunks) noexcept {
+        const size_t base = n / chunks;
+        const size_t rest = n % chunks;
+        return {index * base + std::min(index, rest), base + (index < rest ? 1 : 0)};
+    }
+
+    // Вызывает body(i) для i от 0 до chunks - 1, каждый вызов в своём потоке.
+    // Вызов 0 выполняется в текущем потоке, как и вызовы, для которых не удалось запустить поток.
+    // body не должен бросать исключений
+    template <typename Body>
+    static void RunChunks(size_t chunks, Body body) noexcept {
+        std::unique_ptr<std::thread[]> threads(new (std::nothrow) std::thread[chunks]);
+        for (size_t i = 1; i < chunks; ++i) {
+            try {
+                if (threads == nullptr) {
+                    throw std::bad_alloc();
+                }
+                threads[i] = std::thread(body, i);
+            } catch (...) {
+                body(i);
+            }
+        }
+        body(0);
+        for (size_t i = 1; i < chunks && threads != nullptr; ++i) {
+            if (threads[i].joinable()) {
+                threads[i].join();
+            }
+        }
+    }
+
+    // Конструирует n элементов в buf параллельно вызовами construct(first, count).
+    // construct при исключении должен уничтожать созданные им элементы, как std::uninitialized_*.
+    // Если хотя бы одна часть не создана, уничтожаются остальные и выбрасывается первое исключение
+    template <typename Construct>
+    static void ParallelConstructN(T* buf, size_t n, const ParallelTag& policy, Construct construct) {
+        const size_t chunks = ParallelChunkCount(n, policy);
+        if (chunks == 1) {
+            construct(buf, n);
+            return;
+        }
+        auto errors = std::make_unique<std::exception_ptr[]>(chunks);
+        RunChunks(chunks, [&](size_t i) {
+            try {
+                const auto [first, count] = ChunkBounds(i, n, chunks);
+                construct(buf + first, count);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+
+        std::exception_ptr error;
+        for (size_t i = 0; i < chunks; ++i) {
+            if (errors[i] != nullptr && error == nullptr) {
+                error = errors[i];
+            }
+        }
+        if (error != nullptr) {
+            for (size_t i = 0; i < chunks; ++i) {
+                if (errors[i] == nullptr) {
+                    const auto [first, count] = ChunkBounds(i, n, chunks);
+                    DestroyN(buf + first, count);
+                }
+            }
+            std::rethrow_exception(error);
+        }
+    }
+
+    static void ParallelDestroyN(T* buf, size_t n, const ParallelTag& policy) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            const size_t chunks = ParallelChunkCount(n, policy);
+            RunChunks(chunks, [=](size_t i) {
+                const auto [first, count] = ChunkBounds(i, n, chunks);
+                DestroyN(buf + first, count);
+            });
+        }
+    }
+
+    static VECTOR_CONSTEXPR void DestroyN(T* buf, size_t n) noexcept {
         for (size_t i = 0; i != n; ++i) {
             Destroy(buf + i);
         }
@@ -308,38 +1189,235 @@ private:
         new (buf) T(elem);
     }
 
-    static void Destroy(T* buf) noexcept {
+    static VECTOR_CONSTEXPR void Destroy(T* buf) noexcept {
         std::destroy_at(buf);
     }
 
+    // Копирует тривиально копируемые элементы одним вызовом memcpy
+    static VECTOR_CONSTEXPR void CopyTrivially(const T* from, size_t n, T* to) noexcept {
+        if (vector_detail::IsConstantEvaluated()) {
+            vector_detail::UninitializedCopyN(from, n, to);
+        } else if (n != 0) {
+            std::memcpy(to, from, n * sizeof(T));
+        }
+    }
+
 private:
-    void TryInitMove(int delta, RawMemory<T>& new_data) {
-        try {
-            std::uninitialized_move_n(data_.GetAddress(), delta, new_data.GetAddress());
-        } catch (...) {
-            Destroy(new_data + delta);
-            throw ;
+    VECTOR_CONSTEXPR void RecordAllocation([[maybe_unused]] size_t capacity) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+        if (capacity != 0) {
+            ++stats_.allocations;
+            stats_.bytes_allocated += capacity * sizeof(T);
+            stats_.peak_capacity = std::max(stats_.peak_capacity, capacity);
         }
+#endif
+    }
+
+    // Вызывается перед заменой текущего буфера новым, в который будут перенесены transferred элементов
+    VECTOR_CONSTEXPR void RecordReallocation([[maybe_unused]] size_t new_capacity, [[maybe_unused]] size_t transferred) noexcept {
+#ifdef ADVANCED_VECTOR_STATS
+        RecordAllocation(new_capacity);
+        if (data_.Capacity() != 0) {
+            ++stats_.reallocations;
+        }
+        if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+            stats_.elements_relocated += transferred;
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            stats_.elements_moved += transferred;
+        } else {
+            stats_.elements_copied += transferred;
+        }
+#endif
+    }
+
+    // Уничтожает текущие элементы и забирает буфер other вместе с его аллокатором.
+    // Буферы other и this должны быть выделены равными аллокаторами либо аллокатор должен передаваться
+    VECTOR_CONSTEXPR void AdoptStorage(Vector& other) noexcept {
+        AdoptStorage(other.data_, std::exchange(other.size_, 0));
+    }
+    VECTOR_CONSTEXPR void AdoptStorage(RawMemory<T, Allocator>& other_data, size_t other_size) noexcept {
+        DestroyN(data_.GetAddress(), size_);
+        data_ = std::move(other_data);
+        if constexpr (AllocTraits::propagate_on_container_copy_assignment::value
+                      || AllocTraits::propagate_on_container_move_assignment::value) {
+            data_.GetAllocator() = other_data.GetAllocator();
+        }
+        size_ = other_size;
+    }
+
+    // Заменяет буфер новым буфером аллокатора alloc, в котором transfer создаёт new_size элементов.
+    // Статистика учитывает одно перераспределение. При исключении вектор не меняется
+    template <typename Transfer>
+    VECTOR_CONSTEXPR void ReplaceStorage(size_t new_size, const Allocator& alloc, Transfer transfer) {
+        RawMemory<T, Allocator> new_data(new_size, alloc);
+        transfer(new_data.GetAddress());
+        RecordReallocation(new_size, 0);
+        AdoptStorage(new_data, new_size);
+    }
+
+    // Во время выполнения арифметические типы заполняет векторизованное ядро simd_detail::FillN
+    static VECTOR_CONSTEXPR void FillN(T* dest, size_t n, const T& value) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (!vector_detail::IsConstantEvaluated()) {
+                simd_detail::FillN(dest, n, value);
+                return;
+            }
+        }
+        std::fill_n(dest, n, value);
+    }
+    static VECTOR_CONSTEXPR void UninitializedFillN(T* dest, size_t n, const T& value) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            if (!vector_detail::IsConstantEvaluated()) {
+                simd_detail::FillN(dest, n, value);
+                return;
+            }
+        }
+        vector_detail::UninitializedFillN(dest, n, value);
+    }
+
+    static VECTOR_CONSTEXPR void CopyElements(const Vector& from, T* to) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            CopyTrivially(from.data_.GetAddress(), from.size_, to);
+        } else {
+            vector_detail::UninitializedCopyN(from.data_.GetAddress(), from.size_, to);
+        }
+    }
+
+    template <typename... Args>
+    void ReallocateAndEmplace(size_t delta, size_t new_capacity, Args&&... args) {
+        // Аргументы могут ссылаться на элементы вектора, поэтому новый элемент
+        // создаётся до того, как realloc сделает старый буфер недействительным
+        alignas(T) std::byte slot[sizeof(T)];
+        T* elem = new (slot) T(std::forward<Args>(args)...);
         try {
-            std::uninitialized_move_n(data_ + delta, size_ - delta, new_data + delta + 1);
+            data_.Reallocate(new_capacity);
         } catch (...) {
-            DestroyN(new_data.GetAddress(), delta + 1);
-            throw ;
+            Destroy(elem);
+            throw;
+        }
+        std::memmove(static_cast<void*>(data_ + delta + 1), static_cast<const void*>(data_ + delta),
+                     (size_ - delta) * sizeof(T));
+        std::memcpy(static_cast<void*>(data_ + delta), static_cast<const void*>(elem), sizeof(T));
+    }
+
+    // Переносит элементы в new_data, оставляя на позиции delta count уже созданных там элементов.
+    // При исключении эти элементы уничтожаются, а содержимое вектора не меняется
+    VECTOR_CONSTEXPR void RelocateAroundGap(size_t delta, size_t count, RawMemory<T, Allocator>& new_data) {
+        UninitializedRelocateAroundGap(data_.GetAddress(), size_, delta, count, new_data.GetAddress());
+    }
+
+    // Источник элементов для вставки диапазона
+    template <typename ForwardIt>
+    struct RangeSource {
+        void ConstructN(T* dest, size_t offset, size_t count) const {
+            std::uninitialized_copy_n(std::next(first, offset), count, dest);
+        }
+        void AssignN(T* dest, size_t offset, size_t count) const {
+            std::copy_n(std::next(first, offset), count, dest);
+        }
+
+        ForwardIt first;
+    };
+
+    // Источник из count копий одного значения
+    struct FillSource {
+        void ConstructN(T* dest, size_t /*offset*/, size_t count) const {
+            UninitializedFillN(dest, count, value);
         }
+        void AssignN(T* dest, size_t /*offset*/, size_t count) const {
+            FillN(dest, count, value);
+        }
+
+        const T& value;
+    };
+
+    // Создаёт count элементов в конце вектора вызовами construct(place, i) и увеличивает размер один раз.
+    // При нехватке места элементы создаются в новом буфере до переноса старых
+    template <typename Construct>
+    void AppendN(size_t count, Construct construct) {
+        if (count == 0) {
+            return;
+        }
+        if (size_ + count > Capacity()) {
+            const size_t new_capacity = std::max(size_ + count, GrowthPolicy::NextCapacity(Capacity(), sizeof(T)));
+            RecordReallocation(new_capacity, size_);
+            RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+            ConstructBatch(new_data + size_, count, construct);
+            RelocateAroundGap(size_, count, new_data);
+            data_ = std::move(new_data);
+        } else {
+            ConstructBatch(data_ + size_, count, construct);
+        }
+        size_ += count;
     }
 
-    void TryInitCopy(int delta, RawMemory<T>& new_data) {
+    template <typename Construct>
+    static void ConstructBatch(T* dest, size_t count, Construct& construct) {
+        size_t i = 0;
         try {
-            std::uninitialized_copy_n(data_.GetAddress(), delta, new_data.GetAddress());
+            for (; i < count; ++i) {
+                construct(dest + i, i);
+            }
         } catch (...) {
-            Destroy(new_data + delta);
-            throw ;
+            DestroyN(dest, i);
+            throw;
         }
+    }
+
+    // Вставляет count элементов из source на позицию delta, выполняя не более одной реаллокации
+    // и сдвигая хвост вектора один раз
+    template <typename Source>
+    void InsertN(size_t delta, size_t count, const Source& source) {
+        if (count == 0) {
+            return;
+        }
+        if (size_ + count > Capacity()) {
+            const size_t new_capacity = std::max(size_ + count, GrowthPolicy::NextCapacity(Capacity(), sizeof(T)));
+            RecordReallocation(new_capacity, size_);
+            if constexpr (CAN_REALLOCATE) {
+                data_.Reallocate(new_capacity);
+                InsertIntoGap(delta, count, source);
+            } else {
+                RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+                source.ConstructN(new_data + delta, 0, count);
+                RelocateAroundGap(delta, count, new_data);
+                data_ = std::move(new_data);
+            }
+        } else if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+            InsertIntoGap(delta, count, source);
+        } else {
+            T* pos = data_ + delta;
+            T* old_end = end();
+            const size_t elems_after = size_ - delta;
+            if (elems_after > count) {
+                std::uninitialized_move(old_end - count, old_end, old_end);
+                size_ += count;
+                std::move_backward(pos, old_end - count, old_end);
+                source.AssignN(pos, 0, count);
+                return;
+            }
+            source.ConstructN(old_end, elems_after, count - elems_after);
+            size_ += count - elems_after;
+            std::uninitialized_move(pos, old_end, pos + count);
+            size_ += elems_after;
+            source.AssignN(pos, 0, elems_after);
+            return;
+        }
+        size_ += count;
+    }
+
+    // Раздвигает тривиально перемещаемые элементы побайтово и создаёт новые в образовавшемся промежутке.
+    // Буфер должен вмещать size_ + count элементов
+    template <typename Source>
+    void InsertIntoGap(size_t delta, size_t count, const Source& source) {
+        T* pos = data_ + delta;
+        const size_t tail_bytes = (size_ - delta) * sizeof(T);
+        std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), tail_bytes);
         try {
-            std::uninitialized_copy_n(data_ + delta, size_ - delta, new_data + delta + 1);
+            source.ConstructN(pos, 0, count);
         } catch (...) {
-            DestroyN(new_data.GetAddress(), delta + 1);
-            throw ;
+            std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count), tail_bytes);
+            throw;
         }
     }
 
@@ -0,0 +1,50 @@
+#pragma once
+#include "vector.h"
+#include "vector_simd.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Алгоритмы над Vector арифметических типов на ядрах из vector_simd.h
+template <typename T, typename Allocator, typename GrowthPolicy>
+void Fill(Vector<T, Allocator, GrowthPolicy>& v, T value) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    simd_detail::FillN(v.begin(), v.Size(), value);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::const_iterator Find(const Vector<T, Allocator, GrowthPolicy>& v,
+                                                                 T value) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    return v.begin() + simd_detail::FindN(v.begin(), v.Size(), value);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+typename Vector<T, Allocator, GrowthPolicy>::iterator Find(Vector<T, Allocator, GrowthPolicy>& v, T value) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    return v.begin() + simd_detail::FindN(v.cbegin(), v.Size(), value);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+size_t Count(const Vector<T, Allocator, GrowthPolicy>& v, T value) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    return simd_detail::CountN(v.begin(), v.Size(), value);
+}
+
+// Порядок суммирования чисел с плавающей точкой отличается от последовательного,
+// поэтому результат может отличаться от std::accumulate в пределах погрешности округления
+template <typename T, typename Allocator, typename GrowthPolicy>
+SumResult<T> Sum(const Vector<T, Allocator, GrowthPolicy>& v) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    return simd_detail::SumN(v.begin(), v.Size());
+}
+
+// Возвращает наименьший и наибольший элементы непустого вектора
+template <typename T, typename Allocator, typename GrowthPolicy>
+std::pair<T, T> MinMax(const Vector<T, Allocator, GrowthPolicy>& v) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    assert(v.Size() != 0);
+    return simd_detail::MinMaxN(v.begin(), v.Size());
+}
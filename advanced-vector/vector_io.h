@@ -0,0 +1,242 @@
+#pragma once
+#include "vector.h"
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+
+// Двоичная запись и чтение векторов тривиально копируемых типов.
+// Формат: заголовок VectorIoHeader и следом содержимое буфера вектора как есть.
+// Порядок байтов и представление T должны совпадать у записывающей и читающей стороны.
+// Читаемые данные не считаются доверенными: размер из заголовка проверяется до выделения памяти
+
+struct VectorIoHeader {
+    static constexpr uint64_t MAGIC = 0x4f495443'45564441;  // "ADVECTIO"
+    static constexpr uint32_t VERSION = 1;
+
+    uint64_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t element_size = 0;
+    uint64_t size = 0;
+};
+
+namespace vector_io_detail {
+
+inline void WriteAll(int fd, iovec* iov, int count) {
+    while (count != 0) {
+        ssize_t written = writev(fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "Can't write vector");
+        }
+        // Частичная запись: пропускаются записанные буферы и начало текущего
+        for (; count != 0 && static_cast<size_t>(written) >= iov->iov_len; ++iov, --count) {
+            written -= static_cast<ssize_t>(iov->iov_len);
+        }
+        if (count != 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+            iov->iov_len -= static_cast<size_t>(written);
+        }
+    }
+}
+
+// Возвращает число прочитанных байт, меньшее size только в конце файла
+inline size_t ReadAll(int fd, void* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        const ssize_t n = read(fd, static_cast<char*>(data) + total, size - total);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "Can't read vector");
+        }
+        if (n == 0) {
+            break;
+        }
+        total += static_cast<size_t>(n);
+    }
+    return total;
+}
+
+inline size_t ReadAll(std::istream& in, void* data, size_t size) {
+    in.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+    if (in.bad()) {
+        throw std::runtime_error("Can't read vector");
+    }
+    return static_cast<size_t>(in.gcount());
+}
+
+// Наибольшая порция данных, под которую память выделяется до того, как данные прочитаны
+inline constexpr size_t READ_CHUNK_BYTES = size_t{1} << 20;
+inline constexpr size_t UNKNOWN_LENGTH = std::numeric_limits<size_t>::max();
+
+// Число байт до конца обычного файла либо UNKNOWN_LENGTH для каналов и сокетов
+inline size_t RemainingBytes(int fd) noexcept {
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        return UNKNOWN_LENGTH;
+    }
+    const off_t position = lseek(fd, 0, SEEK_CUR);
+    if (position < 0) {
+        return UNKNOWN_LENGTH;
+    }
+    return position < st.st_size ? static_cast<size_t>(st.st_size - position) : 0;
+}
+inline size_t RemainingBytes(std::istream& /*in*/) noexcept {
+    return UNKNOWN_LENGTH;
+}
+
+template <typename T>
+VectorIoHeader MakeHeader(size_t size) noexcept {
+    VectorIoHeader header;
+    header.element_size = sizeof(T);
+    header.size = size;
+    return header;
+}
+
+template <typename T, typename Source>
+VectorIoHeader ReadHeader(Source& source) {
+    VectorIoHeader header;
+    if (ReadAll(source, &header, sizeof(header)) != sizeof(header)) {
+        throw std::runtime_error("Truncated vector header");
+    }
+    if (header.magic != VectorIoHeader::MAGIC || header.version != VectorIoHeader::VERSION) {
+        throw std::runtime_error("Not a vector file or unsupported version");
+    }
+    if (header.element_size != sizeof(T)) {
+        throw std::runtime_error("Vector was written with elements of another size");
+    }
+    return header;
+}
+
+// Проверяет, что к вектору можно добавить count элементов и что источник может их содержать.
+// Возвращает, подтверждена ли длина данных размером файла
+template <typename T, typename Allocator, typename GrowthPolicy, typename Source>
+bool CheckCount(const Vector<T, Allocator, GrowthPolicy>& v, Source& source, uint64_t count) {
+    const size_t max_size = std::allocator_traits<Allocator>::max_size(v.GetAllocator());
+    if (count > max_size - v.Size()) {
+        throw std::length_error("Vector size in the header is too large");
+    }
+    const size_t remaining = RemainingBytes(source);
+    if (remaining == UNKNOWN_LENGTH) {
+        return false;
+    }
+    if (count > remaining / sizeof(T)) {
+        throw std::runtime_error("Truncated vector data");
+    }
+    return true;
+}
+
+// Дочитывает count элементов в конец вектора, не конструируя их. expected — число элементов,
+// которые по заголовку ещё остаются в источнике. Если длина файла подтверждает их наличие,
+// память выделяется один раз, иначе растёт по мере чтения порциями не больше READ_CHUNK_BYTES,
+// так что повреждённый заголовок не приводит к выделению памяти под несуществующие данные
+template <typename T, typename Allocator, typename GrowthPolicy, typename Source>
+void AppendFrom(Vector<T, Allocator, GrowthPolicy>& v, Source& source, uint64_t count, uint64_t expected) {
+    const size_t old_size = v.Size();
+    if (CheckCount(v, source, expected)) {
+        v.Reserve(old_size + expected);
+    }
+    const size_t chunk = std::max<size_t>(1, READ_CHUNK_BYTES / sizeof(T));
+    for (size_t read = 0; read < count;) {
+        const size_t n = std::min<size_t>(chunk, count - read);
+        const size_t size = v.Size();
+        if (size + n > v.Capacity()) {
+            v.Reserve(std::min<size_t>(size + (expected - read), std::max(size + n, v.Capacity() * 2)));
+        }
+        v.ResizeDefaultInit(size + n);
+        if (ReadAll(source, v.begin() + size, n * sizeof(T)) != n * sizeof(T)) {
+            v.ResizeDefaultInit(old_size);
+            throw std::runtime_error("Truncated vector data");
+        }
+        read += n;
+    }
+}
+
+}  // namespace vector_io_detail
+
+// Записывает вектор одним вызовом writev, повторяя его только при частичной записи
+template <typename T, typename Allocator, typename GrowthPolicy>
+void WriteTo(const Vector<T, Allocator, GrowthPolicy>& v, int fd) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    VectorIoHeader header = vector_io_detail::MakeHeader<T>(v.Size());
+    iovec iov[2] = {{&header, sizeof(header)}, {const_cast<T*>(v.begin()), v.Size() * sizeof(T)}};
+    vector_io_detail::WriteAll(fd, iov, 2);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void WriteTo(const Vector<T, Allocator, GrowthPolicy>& v, std::ostream& out) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const VectorIoHeader header = vector_io_detail::MakeHeader<T>(v.Size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(v.begin()), static_cast<std::streamsize>(v.Size() * sizeof(T)));
+    if (!out) {
+        throw std::runtime_error("Can't write vector");
+    }
+}
+
+// Заменяет содержимое вектора прочитанным. Данные читаются прямо в буфер вектора.
+// Если заголовок повреждён или данные обрываются, вектор остаётся пустым
+template <typename T, typename Allocator, typename GrowthPolicy>
+void ReadFrom(Vector<T, Allocator, GrowthPolicy>& v, int fd) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const VectorIoHeader header = vector_io_detail::ReadHeader<T>(fd);
+    v.Clear();
+    vector_io_detail::AppendFrom(v, fd, header.size, header.size);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void ReadFrom(Vector<T, Allocator, GrowthPolicy>& v, std::istream& in) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const VectorIoHeader header = vector_io_detail::ReadHeader<T>(in);
+    v.Clear();
+    vector_io_detail::AppendFrom(v, in, header.size, header.size);
+}
+
+// Постепенное чтение записанного вектора частями, например чтобы обрабатывать
+// загруженные элементы, пока читаются следующие. Source — файловый дескриптор или std::istream&.
+// Если длина файла подтверждает размер из заголовка, память под все элементы резервируется при первом чтении
+template <typename Source>
+class VectorStreamReader {
+public:
+    explicit VectorStreamReader(Source source)
+    : source_(source) {
+    }
+
+    // Дописывает в конец вектора не больше max_count следующих элементов.
+    // Возвращает число прочитанных элементов, 0 — если все элементы прочитаны
+    template <typename T, typename Allocator, typename GrowthPolicy>
+    size_t ReadNext(Vector<T, Allocator, GrowthPolicy>& v, size_t max_count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (!header_read_) {
+            remaining_ = vector_io_detail::ReadHeader<T>(source_).size;
+            header_read_ = true;
+        }
+        const size_t count = std::min(max_count, remaining_);
+        vector_io_detail::AppendFrom(v, source_, count, remaining_);
+        remaining_ -= count;
+        return count;
+    }
+
+    // Число ещё не прочитанных элементов. Известно после первого ReadNext
+    size_t Remaining() const noexcept {
+        return remaining_;
+    }
+
+private:
+    Source source_;
+    bool header_read_ = false;
+    size_t remaining_ = 0;
+};
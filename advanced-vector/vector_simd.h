@@ -0,0 +1,144 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Ядра алгоритмов над непрерывными массивами арифметических типов.
+// Циклы записаны блоками фиксированной ширины, которые компилятор векторизует.
+// На x86-64 GCC собирает ядра в вариантах для AVX-512, AVX2 и базового набора инструкций
+// и выбирает подходящий при первом вызове (target_clones). На AArch64 NEON входит
+// в базовый набор, поэтому отдельная диспетчеризация не нужна
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define VECTOR_SIMD_DISPATCH __attribute__((target_clones("default", "avx2", "avx512f")))
+#else
+#define VECTOR_SIMD_DISPATCH
+#endif
+
+// Тип суммы элементов: целые суммируются в 64-битном типе той же знаковости
+template <typename T>
+using SumResult = std::conditional_t<std::is_floating_point_v<T>, T,
+                                     std::conditional_t<std::is_signed_v<T>, int64_t, uint64_t>>;
+
+namespace simd_detail {
+
+// Число элементов, обрабатываемых за одну итерацию блочного цикла
+inline constexpr size_t BLOCK = 16;
+
+template <typename T>
+VECTOR_SIMD_DISPATCH void FillN(T* data, size_t n, T value) noexcept {
+    size_t i = 0;
+    for (; i + BLOCK <= n; i += BLOCK) {
+        for (size_t j = 0; j < BLOCK; ++j) {
+            data[i + j] = value;
+        }
+    }
+    for (; i < n; ++i) {
+        data[i] = value;
+    }
+}
+
+// Возвращает индекс первого элемента, равного value, либо n
+template <typename T>
+VECTOR_SIMD_DISPATCH size_t FindN(const T* data, size_t n, T value) noexcept {
+    size_t i = 0;
+    for (; i + BLOCK <= n; i += BLOCK) {
+        // Сравнение блока без ветвлений векторизуется, ветвление остаётся одно на блок
+        unsigned found = 0;
+        for (size_t j = 0; j < BLOCK; ++j) {
+            found |= data[i + j] == value ? 1u : 0u;
+        }
+        if (found != 0) {
+            break;
+        }
+    }
+    for (; i < n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <typename T>
+VECTOR_SIMD_DISPATCH size_t CountN(const T* data, size_t n, T value) noexcept {
+    size_t partial[BLOCK] = {};
+    size_t i = 0;
+    for (; i + BLOCK <= n; i += BLOCK) {
+        for (size_t j = 0; j < BLOCK; ++j) {
+            partial[j] += data[i + j] == value ? 1 : 0;
+        }
+    }
+    size_t count = 0;
+    for (size_t j = 0; j < BLOCK; ++j) {
+        count += partial[j];
+    }
+    for (; i < n; ++i) {
+        count += data[i] == value ? 1 : 0;
+    }
+    return count;
+}
+
+template <typename T>
+VECTOR_SIMD_DISPATCH SumResult<T> SumN(const T* data, size_t n) noexcept {
+    // Независимые частичные суммы позволяют векторизовать и суммирование чисел с плавающей точкой
+    SumResult<T> partial[BLOCK] = {};
+    size_t i = 0;
+    for (; i + BLOCK <= n; i += BLOCK) {
+        for (size_t j = 0; j < BLOCK; ++j) {
+            partial[j] += data[i + j];
+        }
+    }
+    SumResult<T> sum = {};
+    for (size_t j = 0; j < BLOCK; ++j) {
+        sum += partial[j];
+    }
+    for (; i < n; ++i) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+// Массив должен быть непустым
+template <typename T>
+VECTOR_SIMD_DISPATCH std::pair<T, T> MinMaxN(const T* data, size_t n) noexcept {
+    T mins[BLOCK];
+    T maxs[BLOCK];
+    for (size_t j = 0; j < BLOCK; ++j) {
+        mins[j] = data[0];
+        maxs[j] = data[0];
+    }
+    size_t i = 0;
+    for (; i + BLOCK <= n; i += BLOCK) {
+        for (size_t j = 0; j < BLOCK; ++j) {
+            const T elem = data[i + j];
+            mins[j] = elem < mins[j] ? elem : mins[j];
+            maxs[j] = maxs[j] < elem ? elem : maxs[j];
+        }
+    }
+    T min = mins[0];
+    T max = maxs[0];
+    for (size_t j = 1; j < BLOCK; ++j) {
+        min = mins[j] < min ? mins[j] : min;
+        max = max < maxs[j] ? maxs[j] : max;
+    }
+    for (; i < n; ++i) {
+        min = data[i] < min ? data[i] : min;
+        max = max < data[i] ? data[i] : max;
+    }
+    return {min, max};
+}
+
+// Число единичных бит в массиве слов. Варианты для AVX2 и AVX-512 используют инструкцию popcnt
+template <typename Word>
+VECTOR_SIMD_DISPATCH size_t PopCountN(const Word* words, size_t n) noexcept {
+    static_assert(std::is_unsigned_v<Word> && sizeof(Word) == sizeof(unsigned long long));
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        count += static_cast<size_t>(__builtin_popcountll(words[i]));
+    }
+    return count;
+}
+
+}  // namespace simd_detail